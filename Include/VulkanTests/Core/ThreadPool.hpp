@@ -0,0 +1,95 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef VK_TESTS_CORE_THREADPOOL_HPP
+#define VK_TESTS_CORE_THREADPOOL_HPP
+
+#include <VulkanTests/pch.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace VkTests {
+	/**
+	 * @brief A work-stealing thread pool.
+	 *
+	 * Every worker owns a task queue. Tasks submitted from a worker go to its own queue, other tasks are
+	 * distributed between the queues in a round-robin fashion. Each queue has its own lock, and only a count of
+	 * the queued tasks is shared: a worker claims one of them, then pops the newest task of its own queue or steals
+	 * the oldest task of another queue.
+	 *
+	 * A task must not block on the future of another task of the same pool: once every worker waits, nothing is
+	 * left to run the tasks they wait for. Functions waiting on the pool assert that they aren't called from one
+	 * of its workers.
+	 */
+	class ThreadPool {
+	public:
+		/**
+		 * @brief Starts the workers.
+		 * @param threadCount (Optional) The number of workers, defaults to the number of hardware threads.
+		 */
+		explicit ThreadPool(USize threadCount = std::thread::hardware_concurrency());
+
+		/**
+		 * @brief Runs the remaining tasks, then joins the workers.
+		 */
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool(ThreadPool&&) = delete;
+
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		ThreadPool& operator=(ThreadPool&&) = delete;
+
+		/**
+		 * @brief Queues a task to be run by one of the workers.
+		 * @param task The callable to run, taking no arguments.
+		 * @return A future holding the result of the task, or the exception it has thrown.
+		 */
+		template <typename F>
+		std::future<std::invoke_result_t<std::decay_t<F>>> Submit(F&& task);
+
+		[[nodiscard]] inline USize GetThreadCount() const;
+
+		/**
+		 * @brief Checks whether the calling thread is one of the workers of this pool.
+		 */
+		[[nodiscard]] bool IsWorkerThread() const;
+
+	private:
+		struct WorkerQueue {
+			std::mutex Mutex;
+			std::deque<std::function<void()>> Tasks;
+		};
+
+		void Push(std::function<void()> task);
+
+		bool TryPop(USize workerIndex, std::function<void()>& task);
+
+		bool TrySteal(USize workerIndex, std::function<void()>& task);
+
+		void WorkerLoop(USize workerIndex);
+
+		std::vector<std::unique_ptr<WorkerQueue>> m_Queues;
+		std::vector<std::thread> m_Threads;
+
+		std::atomic<USize> m_NextQueue{0};
+
+		// Guards the count of queued tasks not claimed by a worker yet, the queues have their own lock
+		std::mutex m_WakeMutex;
+		std::condition_variable m_WakeCondition;
+		USize m_PendingTasks{0};
+		bool m_Stopping{false};
+	};
+}
+
+#include <VulkanTests/Core/ThreadPool.inl>
+
+#endif // VK_TESTS_CORE_THREADPOOL_HPP
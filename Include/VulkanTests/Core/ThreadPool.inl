@@ -0,0 +1,26 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#pragma once
+
+namespace VkTests {
+	template <typename F>
+	std::future<std::invoke_result_t<std::decay_t<F>>> ThreadPool::Submit(F&& task) {
+		using ResultType = std::invoke_result_t<std::decay_t<F>>;
+
+		// std::function must be copyable, std::packaged_task isn't.
+		auto packagedTask = std::make_shared<std::packaged_task<ResultType()>>(std::forward<F>(task));
+		auto future = packagedTask->get_future();
+
+		Push([packagedTask] {
+			(*packagedTask)();
+		});
+
+		return future;
+	}
+
+	inline USize ThreadPool::GetThreadCount() const {
+		return m_Threads.size();
+	}
+}
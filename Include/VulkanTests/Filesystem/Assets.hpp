@@ -9,6 +9,8 @@
 
 #include <VulkanTests/pch.hpp>
 
+#include <VulkanTests/Filesystem/Filesystem.hpp>
+
 #include <cstdlib>
 #include <sys/stat.h>
 
@@ -93,6 +95,22 @@ namespace VkTests::Filesystem {
 	 */
 	[[nodiscard]] inline std::vector<UInt8> ReadShaderBinary(const std::string& filename);
 
+	/**
+	 * @brief Helper to map an asset file in memory, without copying it
+	 *
+	 * @param filename The path to the file (relative to the assets directory)
+	 * @return A read-only view of the file, invalid if it can't be mapped
+	 */
+	[[nodiscard]] inline MappedFile MapAsset(const std::string& filename);
+
+	/**
+	 * @brief Helper to map a shader file in memory, without copying it
+	 *
+	 * @param filename The path to the file (relative to the assets' directory)
+	 * @return A read-only view of the file, invalid if it can't be mapped
+	 */
+	[[nodiscard]] inline MappedFile MapShader(const std::string& filename);
+
 	/**
 	 * @brief Helper to read a temporary file into a byte-array
 	 *
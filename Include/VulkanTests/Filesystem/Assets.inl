@@ -24,13 +24,22 @@ namespace VkTests::Filesystem {
 	}
 
 	inline std::string ReadShader(const std::string& filename) {
-		return VkTests::Filesystem::Get()->ReadFileString(Paths::Get(Paths::Type::Shaders) + filename);
+		// The string is built straight from the mapping, without an intermediate buffer
+		return std::string{MapShader(filename).GetString()};
 	}
 
 	inline std::vector<UInt8> ReadShaderBinary(const std::string& filename) {
 		return VkTests::Filesystem::Get()->ReadFileBinary(Paths::Get(Paths::Type::Shaders) + filename);
 	}
 
+	inline MappedFile MapAsset(const std::string& filename) {
+		return VkTests::Filesystem::Get()->MapFile(Paths::Get(Paths::Type::Assets) + filename);
+	}
+
+	inline MappedFile MapShader(const std::string& filename) {
+		return VkTests::Filesystem::Get()->MapFile(Paths::Get(Paths::Type::Shaders) + filename);
+	}
+
 	inline std::vector<UInt8> ReadTemp(const std::string& filename) {
 		return VkTests::Filesystem::Get()->ReadFileBinary(Paths::Get(Paths::Type::Temp) + filename);
 	}
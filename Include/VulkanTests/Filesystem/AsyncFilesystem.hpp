@@ -0,0 +1,127 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef VK_TESTS_FILESYSTEM_ASYNCFILESYSTEM_HPP
+#define VK_TESTS_FILESYSTEM_ASYNCFILESYSTEM_HPP
+
+#include <VulkanTests/pch.hpp>
+
+#include <VulkanTests/Filesystem/Filesystem.hpp>
+
+#include <future>
+#include <limits>
+
+namespace VkTests::Filesystem {
+	/**
+	 * @brief Decorates a filesystem with asynchronous reads and writes, run by a background I/O engine.
+	 *
+	 * The synchronous calls are forwarded to the decorated filesystem. On a StdFilesystem, the asynchronous
+	 * operations go through io_uring when built with the io-uring option and supported by the kernel, so a batch
+	 * of reads costs a single system call. Otherwise, they are run on a ThreadPool through the decorated filesystem.
+	 * Asynchronous operations are not ordered with each other, nor with the synchronous calls.
+	 */
+	class AsyncFilesystem final : public Filesystem {
+	public:
+		static constexpr USize WholeFile = std::numeric_limits<USize>::max();
+
+		struct ReadRequest {
+			Path File;
+			USize Offset = 0;
+
+			/// The number of bytes to read, WholeFile to read up to the end of the file.
+			USize Count = WholeFile;
+		};
+
+		struct ReadResult {
+			std::vector<UInt8> Data;
+			bool Success = false;
+		};
+
+		/// Callbacks run on an I/O thread, heavy work should be handed off to keep the I/O flowing.
+		using ReadCallback = std::function<void(ReadResult&& result)>;
+		using BatchReadCallback = std::function<void(USize requestIndex, ReadResult&& result)>;
+		using WriteCallback = std::function<void(bool success)>;
+
+		/**
+		 * @param filesystem The filesystem to decorate.
+		 * @param threadCount The number of workers running the operations when io_uring isn't used.
+		 */
+		explicit AsyncFilesystem(FilesystemPtr filesystem, USize threadCount = 2);
+
+		/**
+		 * @brief Waits for the pending operations to complete.
+		 */
+		~AsyncFilesystem() override;
+
+		AsyncFilesystem(const AsyncFilesystem&) = delete;
+		AsyncFilesystem(AsyncFilesystem&&) = delete;
+
+		AsyncFilesystem& operator=(const AsyncFilesystem&) = delete;
+		AsyncFilesystem& operator=(AsyncFilesystem&&) = delete;
+
+		[[nodiscard]] inline FileStat StatFile(const Path& path) override;
+		[[nodiscard]] inline bool IsFile(const Path& path) override;
+		[[nodiscard]] inline bool IsDirectory(const Path& path) override;
+		[[nodiscard]] inline bool Exists(const Path& path) override;
+		[[nodiscard]] inline bool CreateDirectory(const Path& path) override;
+		[[nodiscard]] inline std::vector<UInt8> ReadChunk(const Path& path, USize offset, USize count) override;
+		inline void WriteFile(const Path& path, const std::vector<UInt8>& data) override;
+		inline void Remove(const Path& path) override;
+		[[nodiscard]] inline MappedFile MapFile(const Path& path) override;
+
+		inline void SetExternalStorageDirectory(const std::string& dir) override;
+		[[nodiscard]] inline const Path& ExternalStorageDirectory() const override;
+		[[nodiscard]] inline const Path& TempDirectory() const override;
+
+		using Filesystem::WriteFile;
+
+		/**
+		 * @brief Reads a range of a file in the background.
+		 * @return A future holding the data read, or a failed result if the range couldn't be read entirely.
+		 */
+		[[nodiscard]] std::future<ReadResult> ReadAsync(const Path& path, USize offset = 0, USize count = WholeFile);
+
+		void ReadAsync(const Path& path, USize offset, USize count, ReadCallback callback);
+
+		/**
+		 * @brief Reads several ranges in the background, submitted to the engine together.
+		 * @return The futures of the requests, in the order of the requests.
+		 */
+		[[nodiscard]] std::vector<std::future<ReadResult>> ReadBatchAsync(const std::vector<ReadRequest>& requests);
+
+		/**
+		 * @param callback Called once per request as it completes, with the index of the request.
+		 */
+		void ReadBatchAsync(const std::vector<ReadRequest>& requests, BatchReadCallback callback);
+
+		/**
+		 * @brief Writes a file in the background, replacing its contents.
+		 * @return A future holding whether the whole data was written.
+		 */
+		[[nodiscard]] std::future<bool> WriteAsync(const Path& path, std::vector<UInt8> data);
+
+		void WriteAsync(const Path& path, std::vector<UInt8> data, WriteCallback callback);
+
+		[[nodiscard]] inline const FilesystemPtr& GetFilesystem() const;
+
+		[[nodiscard]] inline bool UsesIoUring() const;
+
+	private:
+		class Engine;
+		class ThreadPoolEngine;
+		class UringEngine;
+
+		FilesystemPtr m_Filesystem;
+
+		std::unique_ptr<Engine> m_Engine;
+
+		bool m_UsesIoUring{false};
+	};
+}
+
+#include <VulkanTests/Filesystem/AsyncFilesystem.inl>
+
+#endif // VK_TESTS_FILESYSTEM_ASYNCFILESYSTEM_HPP
@@ -0,0 +1,63 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#pragma once
+
+namespace VkTests::Filesystem {
+	inline FileStat AsyncFilesystem::StatFile(const Path& path) {
+		return m_Filesystem->StatFile(path);
+	}
+
+	inline bool AsyncFilesystem::IsFile(const Path& path) {
+		return m_Filesystem->IsFile(path);
+	}
+
+	inline bool AsyncFilesystem::IsDirectory(const Path& path) {
+		return m_Filesystem->IsDirectory(path);
+	}
+
+	inline bool AsyncFilesystem::Exists(const Path& path) {
+		return m_Filesystem->Exists(path);
+	}
+
+	inline bool AsyncFilesystem::CreateDirectory(const Path& path) {
+		return m_Filesystem->CreateDirectory(path);
+	}
+
+	inline std::vector<UInt8> AsyncFilesystem::ReadChunk(const Path& path, const USize offset, const USize count) {
+		return m_Filesystem->ReadChunk(path, offset, count);
+	}
+
+	inline void AsyncFilesystem::WriteFile(const Path& path, const std::vector<UInt8>& data) {
+		m_Filesystem->WriteFile(path, data);
+	}
+
+	inline void AsyncFilesystem::Remove(const Path& path) {
+		m_Filesystem->Remove(path);
+	}
+
+	inline MappedFile AsyncFilesystem::MapFile(const Path& path) {
+		return m_Filesystem->MapFile(path);
+	}
+
+	inline void AsyncFilesystem::SetExternalStorageDirectory(const std::string& dir) {
+		m_Filesystem->SetExternalStorageDirectory(dir);
+	}
+
+	inline const Path& AsyncFilesystem::ExternalStorageDirectory() const {
+		return m_Filesystem->ExternalStorageDirectory();
+	}
+
+	inline const Path& AsyncFilesystem::TempDirectory() const {
+		return m_Filesystem->TempDirectory();
+	}
+
+	inline const FilesystemPtr& AsyncFilesystem::GetFilesystem() const {
+		return m_Filesystem;
+	}
+
+	inline bool AsyncFilesystem::UsesIoUring() const {
+		return m_UsesIoUring;
+	}
+}
@@ -11,6 +11,8 @@
 
 #include <VulkanTests/Platform/Context.hpp>
 
+#include <span>
+
 namespace VkTests::Filesystem {
 	struct FileStat {
 		bool IsFile;
@@ -20,6 +22,50 @@ namespace VkTests::Filesystem {
 
 	using Path = std::filesystem::path;
 
+	/**
+	 * @brief A read-only view of the contents of a file, valid for as long as a handle on it is alive.
+	 *
+	 * The handle shares the ownership of the memory behind the view, which is either a mapping of the file or,
+	 * when the filesystem can't map it, a copy of its contents. Copying a handle doesn't copy the data.
+	 */
+	class MappedFile {
+	public:
+		MappedFile() = default;
+
+		/**
+		 * @param data The contents of the file.
+		 * @param owner Keeps the memory of the contents alive, released with the last handle.
+		 */
+		inline MappedFile(std::span<const UInt8> data, std::shared_ptr<const void> owner);
+
+		/**
+		 * @brief Takes the ownership of contents read into memory.
+		 */
+		inline explicit MappedFile(std::vector<UInt8>&& data);
+
+		/**
+		 * @brief Get a view of a range of the contents, sharing their ownership.
+		 *        The view is invalid if the range is out of bounds.
+		 */
+		[[nodiscard]] inline MappedFile GetView(USize offset, USize count) const;
+
+		[[nodiscard]] inline std::span<const UInt8> GetData() const;
+
+		[[nodiscard]] inline std::string_view GetString() const;
+
+		[[nodiscard]] inline USize GetSize() const;
+
+		/**
+		 * @brief Checks whether the file could be mapped or read. An empty file is still valid.
+		 */
+		[[nodiscard]] inline bool IsValid() const;
+
+	private:
+		std::span<const UInt8> m_Data;
+
+		std::shared_ptr<const void> m_Owner;
+	};
+
 	class Filesystem {
 	public:
 		Filesystem() = default;
@@ -51,16 +97,25 @@ namespace VkTests::Filesystem {
 
 		// Read the entire file into a vector of bytes.
 		[[nodiscard]] inline std::vector<UInt8> ReadFileBinary(const Path& path);
+
+		// Map the entire file in memory, read-only. Filesystems that can't map files read it into memory instead.
+		[[nodiscard]] virtual inline MappedFile MapFile(const Path& path);
 	};
 
 	using FilesystemPtr = std::shared_ptr<Filesystem>;
 
+	// Get the absolute and lexically normal form of a path, with forward slashes and without a trailing one.
+	[[nodiscard]] std::string NormalizePath(const Path& path);
+
 	void Initialize();
 
 	void InitializeWithContext(const PlatformContext& context);
 
 	// Get the filesystem instance.
 	FilesystemPtr Get();
+
+	// Replace the filesystem instance, such as with one layering archives over the current one.
+	void Set(FilesystemPtr filesystem);
 }
 
 #include <VulkanTests/Filesystem/Filesystem.inl>
@@ -5,6 +5,40 @@
 #pragma once
 
 namespace VkTests::Filesystem {
+	inline MappedFile::MappedFile(const std::span<const UInt8> data, std::shared_ptr<const void> owner)
+		: m_Data(data), m_Owner(std::move(owner)) {
+	}
+
+	inline MappedFile::MappedFile(std::vector<UInt8>&& data) {
+		auto owner = std::make_shared<const std::vector<UInt8>>(std::move(data));
+		m_Data = *owner;
+		m_Owner = std::move(owner);
+	}
+
+	inline MappedFile MappedFile::GetView(const USize offset, const USize count) const {
+		if (offset > m_Data.size() || count > m_Data.size() - offset) {
+			return {};
+		}
+
+		return {m_Data.subspan(offset, count), m_Owner};
+	}
+
+	inline std::span<const UInt8> MappedFile::GetData() const {
+		return m_Data;
+	}
+
+	inline std::string_view MappedFile::GetString() const {
+		return {reinterpret_cast<const char*>(m_Data.data()), m_Data.size()};
+	}
+
+	inline USize MappedFile::GetSize() const {
+		return m_Data.size();
+	}
+
+	inline bool MappedFile::IsValid() const {
+		return m_Owner != nullptr;
+	}
+
 	inline void Filesystem::WriteFile(const Path& path, const std::string& data) {
 		WriteFile(path, std::vector<UInt8>(data.begin(), data.end()));
 	}
@@ -17,4 +51,12 @@ namespace VkTests::Filesystem {
 	inline std::vector<UInt8> Filesystem::ReadFileBinary(const Path& path) {
 		return ReadChunk(path, 0, StatFile(path).Size);
 	}
+
+	inline MappedFile Filesystem::MapFile(const Path& path) {
+		if (!IsFile(path)) {
+			return {};
+		}
+
+		return MappedFile{ReadFileBinary(path)};
+	}
 }
@@ -0,0 +1,106 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef VK_TESTS_FILESYSTEM_MEMORYFILESYSTEM_HPP
+#define VK_TESTS_FILESYSTEM_MEMORYFILESYSTEM_HPP
+
+#include <VulkanTests/pch.hpp>
+
+#include <VulkanTests/Filesystem/Filesystem.hpp>
+
+#include <shared_mutex>
+#include <unordered_set>
+
+namespace VkTests::Filesystem {
+	/**
+	 * @brief A filesystem held entirely in memory, without any disk access.
+	 *
+	 * Set as the filesystem instance, it makes the shader compilation, include expansion and asset loading
+	 * hermetic and free of disk noise, for tests and benchmarks. Mounted in a VirtualFilesystem on the temporary
+	 * directory, it keeps intermediate products in memory.
+	 *
+	 * The contents of each file are held in an allocation of their own, and the files are indexed by hashed path.
+	 * Mapping a file doesn't copy it, and the mapping stays valid after the file is overwritten or removed: the
+	 * contents are released with the last mapping of the file, or with the file itself if it isn't mapped. Writing a
+	 * file creates its parent directories.
+	 */
+	class MemoryFilesystem final : public Filesystem {
+	public:
+		explicit MemoryFilesystem(Path externalStorageDirectory = "/", Path tempDirectory = "/tmp");
+		~MemoryFilesystem() override = default;
+
+		MemoryFilesystem(const MemoryFilesystem&) = delete;
+		MemoryFilesystem(MemoryFilesystem&&) = delete;
+
+		MemoryFilesystem& operator=(const MemoryFilesystem&) = delete;
+		MemoryFilesystem& operator=(MemoryFilesystem&&) = delete;
+
+		[[nodiscard]] FileStat StatFile(const Path& path) override;
+		[[nodiscard]] inline bool IsFile(const Path& path) override;
+		[[nodiscard]] inline bool IsDirectory(const Path& path) override;
+		[[nodiscard]] inline bool Exists(const Path& path) override;
+		[[nodiscard]] bool CreateDirectory(const Path& path) override;
+		[[nodiscard]] std::vector<UInt8> ReadChunk(const Path& path, USize offset, USize count) override;
+		void WriteFile(const Path& path, const std::vector<UInt8>& data) override;
+		void Remove(const Path& path) override;
+		[[nodiscard]] MappedFile MapFile(const Path& path) override;
+
+		inline void SetExternalStorageDirectory(const std::string& dir) override;
+		[[nodiscard]] inline const Path& ExternalStorageDirectory() const override;
+		[[nodiscard]] inline const Path& TempDirectory() const override;
+
+		using Filesystem::WriteFile;
+
+		/**
+		 * @brief Writes a file, replacing its contents.
+		 * @param path The path of the file.
+		 * @param data The contents of the file, copied.
+		 */
+		void WriteFile(const Path& path, std::span<const UInt8> data);
+
+		/**
+		 * @brief Removes every file and directory.
+		 */
+		void Clear();
+
+		[[nodiscard]] USize GetFileCount() const;
+
+		/**
+		 * @brief Get the total size of the files, in bytes. Mapped contents of overwritten or removed files aren't
+		 *        counted.
+		 */
+		[[nodiscard]] USize GetStorageSize() const;
+
+	private:
+		struct File {
+			std::span<const UInt8> Data;
+
+			// The allocation holding the contents, shared with the mappings of the file
+			std::shared_ptr<const UInt8[]> Storage;
+		};
+
+		// Copies data into an allocation of its own
+		[[nodiscard]] static File Allocate(std::span<const UInt8> data);
+
+		// Adds a directory and its parents, the lock must be held exclusively
+		void AddDirectories(std::string_view normalizedDirectory);
+
+		Path m_ExternalStorageDirectory;
+		Path m_TempDirectory;
+
+		mutable std::shared_mutex m_Mutex;
+
+		// The files and directories, by normalized path
+		std::unordered_map<std::string, File> m_Files;
+		std::unordered_set<std::string> m_Directories;
+
+		USize m_StorageSize{0};
+	};
+}
+
+#include <VulkanTests/Filesystem/MemoryFilesystem.inl>
+
+#endif // VK_TESTS_FILESYSTEM_MEMORYFILESYSTEM_HPP
@@ -0,0 +1,32 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#pragma once
+
+namespace VkTests::Filesystem {
+	inline bool MemoryFilesystem::IsFile(const Path& path) {
+		return StatFile(path).IsFile;
+	}
+
+	inline bool MemoryFilesystem::IsDirectory(const Path& path) {
+		return StatFile(path).IsDirectory;
+	}
+
+	inline bool MemoryFilesystem::Exists(const Path& path) {
+		const auto stat = StatFile(path);
+		return stat.IsFile || stat.IsDirectory;
+	}
+
+	inline void MemoryFilesystem::SetExternalStorageDirectory(const std::string& dir) {
+		m_ExternalStorageDirectory = dir;
+	}
+
+	inline const Path& MemoryFilesystem::ExternalStorageDirectory() const {
+		return m_ExternalStorageDirectory;
+	}
+
+	inline const Path& MemoryFilesystem::TempDirectory() const {
+		return m_TempDirectory;
+	}
+}
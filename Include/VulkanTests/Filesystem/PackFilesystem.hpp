@@ -0,0 +1,190 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef VK_TESTS_FILESYSTEM_PACKFILESYSTEM_HPP
+#define VK_TESTS_FILESYSTEM_PACKFILESYSTEM_HPP
+
+#include <VulkanTests/pch.hpp>
+
+#include <VulkanTests/Filesystem/Filesystem.hpp>
+
+#include <unordered_set>
+
+namespace VkTests::Filesystem {
+	enum class PackCompression : UInt32 {
+		None,
+		LZ4
+	};
+
+	/**
+	 * @brief Layers a pack archive, produced offline by the AssetPacker tool, over another filesystem.
+	 *
+	 * The archive is mapped once, and the files it contains are served from the mapping under its mount point,
+	 * so reading an asset costs no system call. Paths the archive doesn't contain, and every write, go to the
+	 * underlying filesystem. The archive starts with an index sorted by path hash, followed by the path names,
+	 * then by the contents of the files, each aligned so that uncompressed files can be used in place.
+	 *
+	 * Mounted on the assets directory and set as the filesystem instance, ReadAsset() and MapAsset() read from the
+	 * archive without any change to their callers.
+	 */
+	class PackFilesystem final : public Filesystem {
+	public:
+		static constexpr USize DefaultAlignment = 16;
+
+		/**
+		 * @param filesystem The filesystem serving the paths the archive doesn't contain and the writes, or nullptr
+		 *        for the archive alone, read-only, such as when it is a layer of a VirtualFilesystem.
+		 * @param mountPoint The directory the paths of the archive are relative to, such as the assets directory.
+		 */
+		PackFilesystem(FilesystemPtr filesystem, const Path& mountPoint);
+		~PackFilesystem() override = default;
+
+		PackFilesystem(const PackFilesystem&) = delete;
+		PackFilesystem(PackFilesystem&&) = delete;
+
+		PackFilesystem& operator=(const PackFilesystem&) = delete;
+		PackFilesystem& operator=(PackFilesystem&&) = delete;
+
+		/**
+		 * @brief Loads an archive file, read through the underlying filesystem, or the filesystem instance if none.
+		 * @param path The path of the archive.
+		 * @return True if the archive is valid, false otherwise. The filesystem then serves no file from it.
+		 */
+		bool Open(const Path& path);
+
+		[[nodiscard]] FileStat StatFile(const Path& path) override;
+		[[nodiscard]] inline bool IsFile(const Path& path) override;
+		[[nodiscard]] inline bool IsDirectory(const Path& path) override;
+		[[nodiscard]] inline bool Exists(const Path& path) override;
+		[[nodiscard]] inline bool CreateDirectory(const Path& path) override;
+		[[nodiscard]] std::vector<UInt8> ReadChunk(const Path& path, USize offset, USize count) override;
+		void WriteFile(const Path& path, const std::vector<UInt8>& data) override;
+		void Remove(const Path& path) override;
+		[[nodiscard]] MappedFile MapFile(const Path& path) override;
+
+		inline void SetExternalStorageDirectory(const std::string& dir) override;
+		[[nodiscard]] const Path& ExternalStorageDirectory() const override;
+		[[nodiscard]] const Path& TempDirectory() const override;
+
+		using Filesystem::WriteFile;
+
+		/**
+		 * @brief Get the underlying filesystem, nullptr if the archive is alone.
+		 */
+		[[nodiscard]] inline const FilesystemPtr& GetFilesystem() const;
+
+		[[nodiscard]] inline USize GetEntryCount() const;
+
+		/**
+		 * @brief Checks whether entries compressed with the given method can be read and written by this build.
+		 */
+		[[nodiscard]] static bool IsCompressionSupported(PackCompression compression);
+
+	private:
+		friend class PackWriter;
+
+		struct Header {
+			UInt32 Magic;
+			UInt32 Version;
+			UInt64 EntryCount;
+			UInt64 NamesOffset;
+			UInt64 NamesSize;
+		};
+
+		struct Entry {
+			UInt64 PathHash;
+			UInt64 Offset;
+			UInt64 Size;
+			UInt64 OriginalSize;
+			UInt32 NameOffset;
+			UInt32 NameSize;
+			PackCompression Compression;
+			UInt32 Padding;
+		};
+
+		static constexpr UInt32 Magic = 0x4B415056; // "VPAK"
+		static constexpr UInt32 Version = 1;
+
+		static bool CompareEntries(const Entry& lhs, UInt64 pathHash);
+
+		// Get the path relative to the mount point, or nullopt if the path is outside of it
+		[[nodiscard]] std::optional<std::string> GetRelativePath(const Path& path) const;
+
+		[[nodiscard]] const Entry* FindEntry(std::string_view relativePath) const;
+
+		[[nodiscard]] std::string_view GetName(const Entry& entry) const;
+
+		// Get the contents of an entry, decompressed if needed
+		[[nodiscard]] MappedFile ReadEntry(const Entry& entry) const;
+
+		FilesystemPtr m_Filesystem;
+
+		// Normalized, with forward slashes and without a trailing one
+		std::string m_MountPoint;
+
+		MappedFile m_Data;
+		MappedFile m_Names;
+
+		std::vector<Entry> m_Index;
+
+		// The directories containing the files of the archive, relative to the mount point
+		std::unordered_set<std::string> m_Directories;
+	};
+
+	/**
+	 * @brief Builds a pack archive file.
+	 */
+	class PackWriter {
+	public:
+		PackWriter() = default;
+		~PackWriter() = default;
+
+		PackWriter(const PackWriter&) = delete;
+		PackWriter(PackWriter&&) = delete;
+
+		PackWriter& operator=(const PackWriter&) = delete;
+		PackWriter& operator=(PackWriter&&) = delete;
+
+		/**
+		 * @brief Adds a file to the archive. If the name is already present, the first file is kept.
+		 * @param name The path of the file relative to the mount point, with forward slashes.
+		 * @param data The contents of the file.
+		 * @param compression The compression of the file. It is stored uncompressed instead if compressing it
+		 *        doesn't make it smaller, or if this build doesn't support the method.
+		 */
+		void Add(const std::string& name, std::vector<UInt8> data, PackCompression compression = PackCompression::None);
+
+		/**
+		 * @brief Sets the alignment of the contents of each file in the archive.
+		 * @param alignment A power of two, such as the page size for files meant to be mapped on their own.
+		 */
+		inline void SetAlignment(USize alignment);
+
+		/**
+		 * @brief Writes the archive.
+		 * @param path The path of the archive file.
+		 */
+		void Write(const Path& path) const;
+
+		[[nodiscard]] inline USize GetEntryCount() const;
+
+	private:
+		struct PendingEntry {
+			std::string Name;
+			std::vector<UInt8> Data;
+			USize OriginalSize;
+			PackCompression Compression;
+		};
+
+		std::vector<PendingEntry> m_Entries;
+
+		USize m_Alignment{PackFilesystem::DefaultAlignment};
+	};
+}
+
+#include <VulkanTests/Filesystem/PackFilesystem.inl>
+
+#endif // VK_TESTS_FILESYSTEM_PACKFILESYSTEM_HPP
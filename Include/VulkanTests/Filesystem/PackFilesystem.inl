@@ -0,0 +1,47 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#pragma once
+
+namespace VkTests::Filesystem {
+	inline bool PackFilesystem::IsFile(const Path& path) {
+		return StatFile(path).IsFile;
+	}
+
+	inline bool PackFilesystem::IsDirectory(const Path& path) {
+		return StatFile(path).IsDirectory;
+	}
+
+	inline bool PackFilesystem::Exists(const Path& path) {
+		const auto stat = StatFile(path);
+		return stat.IsFile || stat.IsDirectory;
+	}
+
+	inline bool PackFilesystem::CreateDirectory(const Path& path) {
+		return m_Filesystem && m_Filesystem->CreateDirectory(path);
+	}
+
+	inline void PackFilesystem::SetExternalStorageDirectory(const std::string& dir) {
+		if (m_Filesystem) {
+			m_Filesystem->SetExternalStorageDirectory(dir);
+		}
+	}
+
+	inline const FilesystemPtr& PackFilesystem::GetFilesystem() const {
+		return m_Filesystem;
+	}
+
+	inline USize PackFilesystem::GetEntryCount() const {
+		return m_Index.size();
+	}
+
+	inline void PackWriter::SetAlignment(const USize alignment) {
+		assert(alignment > 0 && (alignment & (alignment - 1)) == 0 && "The alignment must be a power of two.");
+		m_Alignment = alignment;
+	}
+
+	inline USize PackWriter::GetEntryCount() const {
+		return m_Entries.size();
+	}
+}
@@ -32,6 +32,7 @@ namespace VkTests::Filesystem {
 		[[nodiscard]] std::vector<UInt8> ReadChunk(const Path& path, USize offset, USize count) override;
 		void WriteFile(const Path& path, const std::vector<UInt8>& data) override;
 		void Remove(const Path& path) override;
+		[[nodiscard]] MappedFile MapFile(const Path& path) override;
 
 		inline void SetExternalStorageDirectory(const std::string& dir) override;
 		[[nodiscard]] inline const Path& ExternalStorageDirectory() const override;
@@ -0,0 +1,139 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef VK_TESTS_FILESYSTEM_VIRTUALFILESYSTEM_HPP
+#define VK_TESTS_FILESYSTEM_VIRTUALFILESYSTEM_HPP
+
+#include <VulkanTests/pch.hpp>
+
+#include <VulkanTests/Filesystem/Filesystem.hpp>
+
+#include <shared_mutex>
+
+namespace VkTests::Filesystem {
+	/**
+	 * @brief Layers several filesystems, each mounted at a virtual directory with a priority.
+	 *
+	 * A path is served by the mount with the highest priority containing it, among the mounts of the path's
+	 * directory and of its parents, so that a patch archive can override a base archive overriding loose files.
+	 * On equal priorities, the most specific mount wins, then the latest one. The mounts are indexed by directory,
+	 * so resolving a path costs a hash lookup per directory level, whatever the number of mounts, and resolved
+	 * paths are cached in a table indexed by path.
+	 *
+	 * Writes go to the writable mount with the highest priority containing the path. The cache is invalidated by
+	 * the writes and mounts made through the virtual filesystem only, ClearCache() must be called when a file
+	 * is removed from a mounted filesystem directly.
+	 */
+	class VirtualFilesystem final : public Filesystem {
+	public:
+		/**
+		 * @param externalStorageDirectory The storage directory reported to the users of the filesystem, in which
+		 *        the relative paths of Paths::Get() are looked up.
+		 * @param tempDirectory The temporary directory reported to the users of the filesystem.
+		 */
+		VirtualFilesystem(Path externalStorageDirectory, Path tempDirectory);
+		~VirtualFilesystem() override = default;
+
+		VirtualFilesystem(const VirtualFilesystem&) = delete;
+		VirtualFilesystem(VirtualFilesystem&&) = delete;
+
+		VirtualFilesystem& operator=(const VirtualFilesystem&) = delete;
+		VirtualFilesystem& operator=(VirtualFilesystem&&) = delete;
+
+		/**
+		 * @brief Mounts a filesystem at a virtual directory.
+		 * @param directory The virtual directory of the mount.
+		 * @param filesystem The filesystem serving the paths inside the directory, such as a StdFilesystem for
+		 *        loose files or a PackFilesystem without underlying filesystem for an archive.
+		 * @param priority The precedence of the mount over the other mounts containing the same paths.
+		 * @param readOnly Whether writes skip this mount.
+		 * @param root The path in the mounted filesystem the directory maps to, the directory itself if empty.
+		 */
+		void Mount(const Path& directory, FilesystemPtr filesystem, Int32 priority = 0, bool readOnly = false,
+		           const Path& root = {});
+
+		/**
+		 * @brief Unmounts a filesystem from a virtual directory.
+		 * @return True if the filesystem was mounted at the directory.
+		 */
+		bool Unmount(const Path& directory, const FilesystemPtr& filesystem);
+
+		/**
+		 * @brief Forgets the resolved paths, to take changes made to the mounted filesystems directly into account.
+		 */
+		void ClearCache();
+
+		[[nodiscard]] FileStat StatFile(const Path& path) override;
+		[[nodiscard]] inline bool IsFile(const Path& path) override;
+		[[nodiscard]] inline bool IsDirectory(const Path& path) override;
+		[[nodiscard]] inline bool Exists(const Path& path) override;
+		[[nodiscard]] bool CreateDirectory(const Path& path) override;
+		[[nodiscard]] std::vector<UInt8> ReadChunk(const Path& path, USize offset, USize count) override;
+		void WriteFile(const Path& path, const std::vector<UInt8>& data) override;
+		void Remove(const Path& path) override;
+		[[nodiscard]] MappedFile MapFile(const Path& path) override;
+
+		inline void SetExternalStorageDirectory(const std::string& dir) override;
+		[[nodiscard]] inline const Path& ExternalStorageDirectory() const override;
+		[[nodiscard]] inline const Path& TempDirectory() const override;
+
+		using Filesystem::WriteFile;
+
+		[[nodiscard]] inline USize GetMountCount() const;
+
+	private:
+		struct MountPoint {
+			std::string Directory;
+			FilesystemPtr Filesystem;
+			Path Root;
+			Int32 Priority;
+			bool ReadOnly;
+			UInt64 Order;
+		};
+
+		using MountPointPtr = std::shared_ptr<const MountPoint>;
+
+		struct ResolvedPath {
+			MountPointPtr Mount;
+			Path Target;
+		};
+
+		// Get the mounts containing a normalized path, by decreasing precedence
+		[[nodiscard]] std::vector<MountPointPtr> FindMounts(std::string_view normalizedPath) const;
+
+		void InvalidateCache();
+
+		// Get the mount serving an existing path, and the path in its filesystem
+		[[nodiscard]] std::optional<ResolvedPath> Resolve(const Path& path);
+
+		// Get the mount receiving the writes to a path, and the path in its filesystem
+		[[nodiscard]] std::optional<ResolvedPath> ResolveWritable(const Path& path) const;
+
+		[[nodiscard]] static Path Translate(const MountPoint& mount, std::string_view normalizedPath);
+
+		Path m_ExternalStorageDirectory;
+		Path m_TempDirectory;
+
+		// Guards the mounts and the cache, the mounted filesystems are called without holding it
+		mutable std::shared_mutex m_Mutex;
+
+		// The mounts of each virtual directory, by hash of the normalized directory
+		std::unordered_map<UInt64, std::vector<MountPointPtr>> m_Mounts;
+
+		// The mount serving each normalized path resolved so far
+		std::unordered_map<std::string, ResolvedPath> m_Cache;
+
+		// Changes whenever the cache is invalidated, so that resolutions racing with it aren't cached
+		UInt64 m_Generation{0};
+
+		USize m_MountCount{0};
+		UInt64 m_NextOrder{0};
+	};
+}
+
+#include <VulkanTests/Filesystem/VirtualFilesystem.inl>
+
+#endif // VK_TESTS_FILESYSTEM_VIRTUALFILESYSTEM_HPP
@@ -0,0 +1,37 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#pragma once
+
+namespace VkTests::Filesystem {
+	inline bool VirtualFilesystem::IsFile(const Path& path) {
+		return StatFile(path).IsFile;
+	}
+
+	inline bool VirtualFilesystem::IsDirectory(const Path& path) {
+		return StatFile(path).IsDirectory;
+	}
+
+	inline bool VirtualFilesystem::Exists(const Path& path) {
+		const auto stat = StatFile(path);
+		return stat.IsFile || stat.IsDirectory;
+	}
+
+	inline void VirtualFilesystem::SetExternalStorageDirectory(const std::string& dir) {
+		m_ExternalStorageDirectory = dir;
+	}
+
+	inline const Path& VirtualFilesystem::ExternalStorageDirectory() const {
+		return m_ExternalStorageDirectory;
+	}
+
+	inline const Path& VirtualFilesystem::TempDirectory() const {
+		return m_TempDirectory;
+	}
+
+	inline USize VirtualFilesystem::GetMountCount() const {
+		std::shared_lock lock{m_Mutex};
+		return m_MountCount;
+	}
+}
@@ -7,10 +7,17 @@
 #ifndef VK_TESTS_LIBS_KTX_HPP
 #define VK_TESTS_LIBS_KTX_HPP
 
+#include <VulkanTests/Filesystem/Filesystem.hpp>
+
 #include <ktx.h>
 
 namespace VkTests {
     inline ktxTexture* LoadTexture(const std::string& filename);
+
+    /**
+     * @brief Loads a texture from a file mapped in memory, the file can be released once the texture is loaded.
+     */
+    inline ktxTexture* LoadTexture(const Filesystem::MappedFile& file, std::string_view name = {});
 }
 
 #include <VulkanTests/Libs/KTX.inl>
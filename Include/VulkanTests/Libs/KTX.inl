@@ -8,14 +8,25 @@
 
 namespace VkTests {
     inline ktxTexture* LoadTexture(const std::string& filename) {
+        // Mapped rather than read through stdio, libktx copies the image data only once
+        const auto file = Filesystem::Get()->MapFile(filename);
+        if (!file.IsValid()) {
+            Log::Error("Failed to load texture: {}", filename.c_str());
+            return nullptr;
+        }
+
+        return LoadTexture(file, filename);
+    }
+
+    inline ktxTexture* LoadTexture(const Filesystem::MappedFile& file, const std::string_view name) {
         ktxTexture* texture;
-        const KTX_error_code result = ktxTexture_CreateFromNamedFile(filename.c_str(),
-                                                                KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &texture);
+        const KTX_error_code result = ktxTexture_CreateFromMemory(file.GetData().data(), file.GetSize(),
+                                                                  KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &texture);
         if ((result != KTX_SUCCESS) || (texture == nullptr)) {
-            Log::Error("Failed to load texture: {}", filename.c_str());
+            Log::Error("Failed to load texture: {}", name);
             return nullptr;
         }
-        
+
         return texture;
     }
 }
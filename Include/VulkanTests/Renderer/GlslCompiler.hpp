@@ -13,7 +13,9 @@
 
 #include <glslang/Public/ShaderLang.h>
 
+#include <VulkanTests/Renderer/ShaderStats.hpp>
 #include <VulkanTests/Renderer/VkCommon.hpp>
+#include <VulkanTests/Renderer/VulkanWrapper/ShaderModule.hpp>
 
 namespace VkTests {
 	class GlslCompiler {
@@ -44,18 +46,37 @@ namespace VkTests {
 		static void ResetTargetEnvironment();
 
 		/**
-		 * @brief Compiles GLSL to SPIR-V bytecode.
+		 * @brief Compiles GLSL or HLSL, as given by the language of the source, to SPIR-V bytecode.
+		 *        Results are looked up in and stored to the ShaderCache, a cache hit doesn't invoke glslang.
 		 * @param stage The Vulkan shader stage flag.
-		 * @param glslSource The GLSL source code to be compiled.
+		 * @param glslSource The source code to be compiled, with its includes expanded.
+		 *        Each segment is passed to glslang as a separate string named after its file.
 		 * @param entryPoint The entry point name of the shader.
 		 * @param shaderVariant The shader variant.
 		 * @param[out] spirv The generated SPIR-V code.
 		 * @param[out] infoLog Stores any log messages during the compilation process. 
+		 * @param[out] diagnostics Stores the compiler and validator messages, with their location.
+		 * @param[out] stats Receives the parse, link and SPIR-V generation times and whether the cache was hit,
+		 *        may be null.
 		 * @return True if the compilation was successful, false otherwise.
 		 */
-		static bool CompileToSpirv(VkShaderStageFlagBits stage, const std::vector<UInt8>& glslSource,
+		static bool CompileToSpirv(VkShaderStageFlagBits stage, const ExpandedShaderSource& glslSource,
 		                           const std::string& entryPoint, const ShaderVariant& shaderVariant,
-		                           std::vector<UInt32>& spirv, std::string& infoLog);
+		                           std::vector<UInt32>& spirv, std::string& infoLog,
+		                           std::vector<ShaderDiagnostic>& diagnostics, ShaderCompileStats* stats = nullptr);
+
+		/**
+		 * @brief Runs the glslang preprocessor only, without compiling.
+		 *        Two variants whose preprocessed sources are identical compile to the same SPIR-V.
+		 * @param stage The Vulkan shader stage flag.
+		 * @param glslSource The GLSL source code to be preprocessed, with its includes expanded.
+		 * @param shaderVariant The shader variant.
+		 * @param[out] output The preprocessed source code.
+		 * @param[out] infoLog Stores any log messages during the preprocessing.
+		 * @return True if the preprocessing was successful, false otherwise.
+		 */
+		static bool Preprocess(VkShaderStageFlagBits stage, const ExpandedShaderSource& glslSource,
+		                       const ShaderVariant& shaderVariant, std::string& output, std::string& infoLog);
 	};
 }
 
@@ -0,0 +1,46 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef VK_TESTS_RENDERER_GLSLANGSESSION_HPP
+#define VK_TESTS_RENDERER_GLSLANGSESSION_HPP
+
+#include <VulkanTests/pch.hpp>
+
+#include <mutex>
+
+namespace VkTests {
+    /**
+     * @brief Keeps the glslang library initialized for as long as a session is alive.
+     *
+     * Sessions are shared: the library is initialized when the first one is acquired and finalized
+     * when the last one is released. Hold a session around a batch of compilations to avoid
+     * initializing and finalizing glslang for every shader.
+     */
+    class GlslangSession {
+    public:
+        ~GlslangSession();
+
+        GlslangSession(const GlslangSession&) = delete;
+        GlslangSession(GlslangSession&&) = delete;
+
+        GlslangSession& operator=(const GlslangSession&) = delete;
+        GlslangSession& operator=(GlslangSession&&) = delete;
+
+        /**
+         * @brief Get a handle on the glslang session, initializing the library if no session is alive.
+         * @return A handle keeping the library initialized until it is released.
+         */
+        [[nodiscard]] static std::shared_ptr<GlslangSession> Acquire();
+
+    private:
+        GlslangSession();
+
+        static std::mutex m_SMutex;
+        static std::weak_ptr<GlslangSession> m_SInstance;
+    };
+}
+
+#endif // VK_TESTS_RENDERER_GLSLANGSESSION_HPP
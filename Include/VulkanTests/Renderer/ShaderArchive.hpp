@@ -0,0 +1,163 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef VK_TESTS_RENDERER_SHADERARCHIVE_HPP
+#define VK_TESTS_RENDERER_SHADERARCHIVE_HPP
+
+#include <VulkanTests/pch.hpp>
+
+#include <VulkanTests/Renderer/VulkanWrapper/ShaderModule.hpp>
+
+#include <VulkanTests/Filesystem/Filesystem.hpp>
+
+#include <VulkanTests/Utils/Hash.hpp>
+
+#include <atomic>
+
+namespace VkTests {
+    /**
+     * @brief A read-only archive of precompiled shaders, produced offline by the ShaderBaker tool.
+     *
+     * The archive holds the SPIR-V code and the serialized reflection of every baked shader,
+     * and an index sorted by key. The index and every entry are checksummed, a corrupted entry isn't loaded.
+     * Once an archive is mounted, ShaderModule loads the shaders it contains directly from it, without invoking
+     * glslang, as long as their source isn't on disk. A source on disk may have been edited since it was baked,
+     * so it is always compiled.
+     */
+    class ShaderArchive {
+    public:
+        ShaderArchive() = default;
+        ~ShaderArchive() = default;
+
+        ShaderArchive(const ShaderArchive&) = delete;
+        ShaderArchive(ShaderArchive&&) = delete;
+
+        ShaderArchive& operator=(const ShaderArchive&) = delete;
+        ShaderArchive& operator=(ShaderArchive&&) = delete;
+
+        /**
+         * @brief Loads an archive file.
+         * @param path The path of the archive.
+         * @return True if the archive is valid, false otherwise.
+         */
+        bool Open(const std::string& path);
+
+        /**
+         * @brief Looks up a shader in the archive.
+         * @param key The key of the shader, see ComputeKey().
+         * @param[out] result The SPIR-V code and reflected resources of the shader.
+         * @return True if the archive contains the shader, false otherwise.
+         */
+        bool Find(const Hash128& key, ShaderCompileResult& result) const;
+
+        [[nodiscard]] inline USize GetEntryCount() const;
+
+        /**
+         * @brief Computes the key of a shader, as used by the baker and at runtime.
+         * @param stage The Vulkan shader stage flag.
+         * @param filename The filename of the shader source, relative to the shaders directory.
+         * @param language The language of the shader source.
+         * @param entryPoint The entry point name of the shader.
+         * @param shaderVariant The shader variant.
+         * @return The key of the shader.
+         */
+        [[nodiscard]] static Hash128 ComputeKey(VkShaderStageFlagBits stage, const std::string& filename,
+                                                ShadingLanguage language, const std::string& entryPoint,
+                                                const ShaderVariant& shaderVariant);
+
+        /**
+         * @brief Sets the archive ShaderModule loads from, nullptr to compile every shader from source.
+         */
+        static inline void Mount(std::shared_ptr<const ShaderArchive> archive);
+
+        [[nodiscard]] static inline std::shared_ptr<const ShaderArchive> GetMounted();
+
+    private:
+        friend class ShaderArchiveWriter;
+
+        struct Header {
+            UInt32 Magic;
+            UInt32 Version;
+            UInt64 EntryCount;
+            UInt64 IndexOffset;
+
+            // Checksum of the index, each entry checksums its own data
+            UInt64 IndexChecksum;
+        };
+
+        struct Entry {
+            Hash128 Key;
+            UInt32 Stage;
+            UInt32 Padding;
+            UInt64 SpirvOffset;
+            UInt64 SpirvSize;
+            UInt64 ReflectionOffset;
+            UInt64 ReflectionSize;
+
+            // Checksum of the SPIR-V code followed by the reflection data
+            UInt64 Checksum;
+        };
+
+        static constexpr UInt32 Magic = 0x52415356; // "VSAR"
+        static constexpr UInt32 Version = 3;
+
+        static bool CompareKeys(const Hash128& lhs, const Hash128& rhs);
+
+        [[nodiscard]] static UInt64 ComputeChecksum(const UInt8* spirv, USize spirvSize, const UInt8* reflection,
+                                                    USize reflectionSize);
+
+        Filesystem::MappedFile m_Data;
+
+        std::vector<Entry> m_Index;
+
+        static std::atomic<std::shared_ptr<const ShaderArchive>> m_SMounted;
+    };
+
+    /**
+     * @brief Builds a ShaderArchive file.
+     */
+    class ShaderArchiveWriter {
+    public:
+        ShaderArchiveWriter() = default;
+        ~ShaderArchiveWriter() = default;
+
+        ShaderArchiveWriter(const ShaderArchiveWriter&) = delete;
+        ShaderArchiveWriter(ShaderArchiveWriter&&) = delete;
+
+        ShaderArchiveWriter& operator=(const ShaderArchiveWriter&) = delete;
+        ShaderArchiveWriter& operator=(ShaderArchiveWriter&&) = delete;
+
+        /**
+         * @brief Adds a compiled shader to the archive. If the key is already present, the first shader is kept.
+         * @param key The key of the shader, see ShaderArchive::ComputeKey().
+         * @param stage The Vulkan shader stage flag.
+         * @param result The successful compilation result of the shader.
+         */
+        void Add(const Hash128& key, VkShaderStageFlagBits stage, const ShaderCompileResult& result);
+
+        /**
+         * @brief Writes the archive.
+         * @param path The path of the archive file.
+         */
+        void Write(const std::string& path) const;
+
+        [[nodiscard]] inline USize GetEntryCount() const;
+
+    private:
+        struct PendingEntry {
+            Hash128 Key;
+            VkShaderStageFlagBits Stage;
+            std::vector<UInt32> Spirv;
+            std::vector<UInt8> Reflection;
+        };
+
+        std::vector<PendingEntry> m_Entries;
+    };
+}
+
+#include <VulkanTests/Renderer/ShaderArchive.inl>
+
+#endif // VK_TESTS_RENDERER_SHADERARCHIVE_HPP
@@ -0,0 +1,23 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#pragma once
+
+namespace VkTests {
+    inline USize ShaderArchive::GetEntryCount() const {
+        return m_Index.size();
+    }
+
+    inline void ShaderArchive::Mount(std::shared_ptr<const ShaderArchive> archive) {
+        m_SMounted.store(std::move(archive));
+    }
+
+    inline std::shared_ptr<const ShaderArchive> ShaderArchive::GetMounted() {
+        return m_SMounted.load();
+    }
+
+    inline USize ShaderArchiveWriter::GetEntryCount() const {
+        return m_Entries.size();
+    }
+}
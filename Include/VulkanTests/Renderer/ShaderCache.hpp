@@ -0,0 +1,112 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef VK_TESTS_RENDERER_SHADERCACHE_HPP
+#define VK_TESTS_RENDERER_SHADERCACHE_HPP
+
+#include <VulkanTests/pch.hpp>
+
+#include <VulkanTests/Renderer/VkCommon.hpp>
+#include <VulkanTests/Renderer/VulkanWrapper/ShaderModule.hpp>
+
+#include <VulkanTests/Utils/Hash.hpp>
+
+#include <glslang/Public/ShaderLang.h>
+
+#include <atomic>
+
+namespace VkTests {
+    /**
+     * @brief Persistent, content-addressed cache of compiled SPIR-V modules.
+     *
+     * SPIR-V modules and their reflected resources are cached separately, the reflection being keyed
+     * by the SPIR-V it was generated from.
+     * Entries are stored in the storage directory, one file per key. Each file starts with a header
+     * holding the key and a checksum of the payload, so truncated or stale entries are detected and recompiled.
+     */
+    class ShaderCache {
+        static std::atomic<bool> m_SEnabled;
+
+    public:
+        ShaderCache() = delete;
+
+        /**
+         * @brief Enable or disable the cache. It is enabled by default.
+         */
+        static inline void SetEnabled(bool enabled);
+
+        [[nodiscard]] static inline bool IsEnabled();
+
+        /**
+         * @brief Computes the cache key of a compilation.
+         * @param stage The Vulkan shader stage flag.
+         * @param entryPoint The entry point name of the shader.
+         * @param shaderVariant The shader variant, its preamble and SPIR-V post-processing settings
+         *        are part of the key.
+         * @param source The fully expanded shader source.
+         * @param language The language of the shader source.
+         * @param targetLanguage The glslang target language.
+         * @param targetLanguageVersion The glslang target language version.
+         * @return The key identifying the compilation, which also depends on whether the build validates SPIR-V.
+         */
+        [[nodiscard]] static Hash128 ComputeKey(VkShaderStageFlagBits stage, const std::string& entryPoint,
+                                                const ShaderVariant& shaderVariant, std::string_view source,
+                                                ShadingLanguage language, glslang::EShTargetLanguage targetLanguage,
+                                                glslang::EShTargetLanguageVersion targetLanguageVersion);
+
+        /**
+         * @brief Loads a cached SPIR-V module.
+         * @param key The cache key of the compilation.
+         * @param[out] spirv The cached SPIR-V code.
+         * @return True if a valid entry was found, false otherwise.
+         */
+        static bool Load(const Hash128& key, std::vector<UInt32>& spirv);
+
+        /**
+         * @brief Stores a SPIR-V module in the cache, replacing any previous entry with the same key.
+         * @param key The cache key of the compilation.
+         * @param spirv The SPIR-V code to store.
+         */
+        static void Store(const Hash128& key, const std::vector<UInt32>& spirv);
+
+        /**
+         * @brief Computes the cache key of the reflection of a SPIR-V module.
+         * @param stage The Vulkan shader stage flag.
+         * @param spirv The SPIR-V code that is reflected.
+         * @param shaderVariant The shader variant, only its runtime array sizes are part of the key.
+         * @return The key identifying the reflection.
+         */
+        [[nodiscard]] static Hash128 ComputeReflectionKey(VkShaderStageFlagBits stage, const std::vector<UInt32>& spirv,
+                                                          const ShaderVariant& shaderVariant);
+
+        /**
+         * @brief Loads cached reflected resources, sparing the SPIR-V parsing of a reflection.
+         * @param key The cache key of the reflection.
+         * @param[out] resources The cached shader resources.
+         * @return True if a valid entry was found, false otherwise.
+         */
+        static bool LoadReflection(const Hash128& key, std::vector<ShaderResource>& resources);
+
+        /**
+         * @brief Stores reflected resources in the cache, replacing any previous entry with the same key.
+         * @param key The cache key of the reflection.
+         * @param resources The shader resources to store.
+         */
+        static void StoreReflection(const Hash128& key, const std::vector<ShaderResource>& resources);
+
+    private:
+        static bool ReadEntry(const Hash128& key, std::string_view extension, std::vector<UInt8>& payload);
+
+        static void WriteEntry(const Hash128& key, std::string_view extension, const void* payload,
+                               USize payloadSize);
+
+        [[nodiscard]] static std::string GetEntryPath(const Hash128& key, std::string_view extension);
+    };
+}
+
+#include <VulkanTests/Renderer/ShaderCache.inl>
+
+#endif // VK_TESTS_RENDERER_SHADERCACHE_HPP
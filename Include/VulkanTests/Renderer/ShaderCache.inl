@@ -0,0 +1,15 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#pragma once
+
+namespace VkTests {
+    inline void ShaderCache::SetEnabled(const bool enabled) {
+        m_SEnabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    inline bool ShaderCache::IsEnabled() {
+        return m_SEnabled.load(std::memory_order_relaxed);
+    }
+}
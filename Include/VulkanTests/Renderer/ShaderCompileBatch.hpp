@@ -0,0 +1,78 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef VK_TESTS_RENDERER_SHADERCOMPILEBATCH_HPP
+#define VK_TESTS_RENDERER_SHADERCOMPILEBATCH_HPP
+
+#include <VulkanTests/pch.hpp>
+
+#include <VulkanTests/Core/ThreadPool.hpp>
+
+#include <VulkanTests/Renderer/VulkanWrapper/ShaderModule.hpp>
+
+namespace VkTests {
+    /**
+     * @brief A shader to be compiled as part of a ShaderCompileBatch.
+     */
+    struct ShaderCompileRequest {
+        VkShaderStageFlagBits Stage;
+
+        ShaderSource Source;
+
+        std::string EntryPoint;
+
+        ShaderVariant Variant;
+    };
+
+    /**
+     * @brief Compiles many shaders in parallel on a thread pool.
+     *
+     * The glslang library is initialized once for the whole batch, then each shader is compiled and reflected
+     * independently, as ShaderModule::Compile would.
+     */
+    class ShaderCompileBatch {
+    public:
+        ShaderCompileBatch() = default;
+        ~ShaderCompileBatch() = default;
+
+        ShaderCompileBatch(const ShaderCompileBatch&) = delete;
+        ShaderCompileBatch(ShaderCompileBatch&&) = default;
+
+        ShaderCompileBatch& operator=(const ShaderCompileBatch&) = delete;
+        ShaderCompileBatch& operator=(ShaderCompileBatch&&) = default;
+
+        /**
+         * @brief Adds a shader to the batch.
+         * @param stage The Vulkan shader stage flag.
+         * @param source The GLSL source of the shader.
+         * @param entryPoint The entry point name of the shader.
+         * @param variant The shader variant.
+         * @return The index of the shader's result in the vector returned by Compile().
+         */
+        USize Add(VkShaderStageFlagBits stage, const ShaderSource& source, const std::string& entryPoint,
+                  const ShaderVariant& variant);
+
+        /**
+         * @brief Compiles every shader of the batch, blocking until all of them are done.
+         * @param threadPool The thread pool to compile on, not called from one of its workers.
+         * @return One result per shader, in the order they were added.
+         */
+        [[nodiscard]] std::vector<ShaderCompileResult> Compile(ThreadPool& threadPool) const;
+
+        [[nodiscard]] inline const std::vector<ShaderCompileRequest>& GetRequests() const;
+
+        [[nodiscard]] inline USize GetSize() const;
+
+        inline void Clear();
+
+    private:
+        std::vector<ShaderCompileRequest> m_Requests;
+    };
+}
+
+#include <VulkanTests/Renderer/ShaderCompileBatch.inl>
+
+#endif // VK_TESTS_RENDERER_SHADERCOMPILEBATCH_HPP
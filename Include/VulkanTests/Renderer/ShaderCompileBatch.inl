@@ -0,0 +1,19 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#pragma once
+
+namespace VkTests {
+    inline const std::vector<ShaderCompileRequest>& ShaderCompileBatch::GetRequests() const {
+        return m_Requests;
+    }
+
+    inline USize ShaderCompileBatch::GetSize() const {
+        return m_Requests.size();
+    }
+
+    inline void ShaderCompileBatch::Clear() {
+        m_Requests.clear();
+    }
+}
@@ -0,0 +1,101 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef VK_TESTS_RENDERER_SHADERHOTRELOADER_HPP
+#define VK_TESTS_RENDERER_SHADERHOTRELOADER_HPP
+
+#include <VulkanTests/pch.hpp>
+
+#include <VulkanTests/Renderer/VulkanWrapper/ShaderModule.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace VkTests {
+    class GlslangSession;
+
+    /**
+     * @brief Recompiles shader modules when their source files change on disk.
+     *
+     * A background thread watches the shader directory (with inotify on Linux, by polling modification times
+     * elsewhere). When files change, only the watched modules whose source or includes changed are recompiled,
+     * on that same thread. Each new compilation is published atomically and swapped into its module by
+     * ApplyReloads(), which is meant to be called from the thread owning the modules.
+     */
+    class ShaderHotReloader {
+    public:
+        using Handle = USize;
+
+        /// Called for every module swapped in by ApplyReloads(), to rebuild the pipelines using it.
+        using ReloadCallback = std::function<void(ShaderModule&)>;
+
+        ShaderHotReloader();
+        ~ShaderHotReloader();
+
+        ShaderHotReloader(const ShaderHotReloader&) = delete;
+        ShaderHotReloader(ShaderHotReloader&&) = delete;
+
+        ShaderHotReloader& operator=(const ShaderHotReloader&) = delete;
+        ShaderHotReloader& operator=(ShaderHotReloader&&) = delete;
+
+        /**
+         * @brief Starts watching a module. The reloader only keeps a weak reference on it, a destroyed module is
+         *        no longer reloaded and is forgotten by the next ApplyReloads().
+         * @param module The module to reload.
+         * @param glslSource The GLSL source the module was compiled from.
+         * @param shaderVariant The shader variant the module was compiled with.
+         * @return A handle to unwatch the module.
+         */
+        Handle Watch(const std::shared_ptr<ShaderModule>& module, const ShaderSource& glslSource,
+                     const ShaderVariant& shaderVariant);
+
+        void Unwatch(Handle handle);
+
+        /**
+         * @brief Swaps the latest compilations into their modules.
+         * @param callback (Optional) Called for every module that was reloaded.
+         * @return The number of modules reloaded.
+         */
+        USize ApplyReloads(const ReloadCallback& callback = {});
+
+    private:
+        struct WatchedShader {
+            std::weak_ptr<ShaderModule> Module;
+
+            VkShaderStageFlagBits Stage;
+
+            std::string Filename;
+
+            ShadingLanguage Language;
+
+            std::string EntryPoint;
+
+            ShaderVariant Variant;
+
+            std::atomic<std::shared_ptr<ShaderCompileResult>> Pending;
+        };
+
+        void WatchLoop(const std::filesystem::path& root);
+
+        void Recompile(const std::set<std::string>& changedFiles);
+
+        std::shared_ptr<GlslangSession> m_GlslangSession;
+
+        std::mutex m_Mutex;
+
+        std::unordered_map<Handle, std::shared_ptr<WatchedShader>> m_Shaders;
+
+        Handle m_NextHandle{0};
+
+        std::atomic<bool> m_Running{true};
+
+        std::thread m_Thread;
+    };
+}
+
+#endif // VK_TESTS_RENDERER_SHADERHOTRELOADER_HPP
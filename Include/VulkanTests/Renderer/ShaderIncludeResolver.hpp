@@ -0,0 +1,128 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef VK_TESTS_RENDERER_SHADERINCLUDERESOLVER_HPP
+#define VK_TESTS_RENDERER_SHADERINCLUDERESOLVER_HPP
+
+#include <VulkanTests/pch.hpp>
+
+#include <VulkanTests/Renderer/VulkanWrapper/ShaderModule.hpp>
+
+#include <mutex>
+#include <set>
+
+namespace VkTests {
+    /**
+     * @brief Expands the #include "file" directives of project shaders.
+     *
+     * Include paths are relative to the base shader directory. Every include file is read and parsed once
+     * per process, files containing #pragma once are only expanded once per shader, and include cycles are
+     * reported as errors. The expanded text is written to a single buffer, with #line directives keeping the
+     * line numbers of each file. The include graph of each expanded shader is recorded, so the shaders
+     * depending on a given file can be found. This class is thread-safe.
+     */
+    class ShaderIncludeResolver {
+    public:
+        ShaderIncludeResolver() = default;
+        ~ShaderIncludeResolver() = default;
+
+        ShaderIncludeResolver(const ShaderIncludeResolver&) = delete;
+        ShaderIncludeResolver(ShaderIncludeResolver&&) = delete;
+
+        ShaderIncludeResolver& operator=(const ShaderIncludeResolver&) = delete;
+        ShaderIncludeResolver& operator=(ShaderIncludeResolver&&) = delete;
+
+        /**
+         * @brief Get the process-wide resolver.
+         */
+        [[nodiscard]] static ShaderIncludeResolver& Get();
+
+        /**
+         * @brief Expands the includes of a shader source.
+         * @param source The shader source to expand.
+         * @param[out] expanded The expanded shader.
+         * @param[out] infoLog The error message, if expansion failed.
+         * @return True if the expansion was successful, false otherwise.
+         */
+        bool Expand(const ShaderSource& source, ExpandedShaderSource& expanded, std::string& infoLog);
+
+        /**
+         * @brief Drops the cached content of an include file, it will be read again on its next use.
+         * @param filename The filename of the include file.
+         */
+        void Invalidate(const std::string& filename);
+
+        /**
+         * @brief Get every file a shader includes, directly or not, as recorded by its last expansion.
+         * @param filename The filename of the shader source.
+         * @return The included files, sorted.
+         */
+        [[nodiscard]] std::vector<std::string> GetDependencies(const std::string& filename) const;
+
+        /**
+         * @brief Get the shader sources depending on a file: the ones including it, directly or not,
+         *        and the file itself if it is an expanded shader source.
+         * @param filename The filename of the file.
+         * @return The filenames of the shader sources depending on the file, sorted.
+         */
+        [[nodiscard]] std::vector<std::string> GetDependents(const std::string& filename) const;
+
+    private:
+        /// A run of text, followed by the file it includes, if any.
+        struct Chunk {
+            USize Offset;
+            USize Length;
+            UInt32 FirstLine;
+
+            std::string Include;
+        };
+
+        struct ParsedFile {
+            std::vector<Chunk> Chunks;
+
+            bool PragmaOnce = false;
+        };
+
+        struct IncludeFile {
+            std::string Text;
+
+            ParsedFile Parsed;
+        };
+
+        using IncludeFilePtr = std::shared_ptr<const IncludeFile>;
+
+        struct ExpansionState {
+            ExpandedShaderSource& Output;
+
+            std::string& InfoLog;
+
+            // Files being expanded, from the shader source to the innermost include
+            std::vector<std::string> Stack;
+
+            // Files with #pragma once that were already expanded
+            std::set<std::string> Once;
+
+            std::set<std::string> Dependencies;
+        };
+
+        static ParsedFile Parse(std::string_view text);
+
+        static void AppendSegment(ExpansionState& state, std::string_view text, UInt32 firstLine, UInt32 file);
+
+        IncludeFilePtr LoadInclude(const std::string& filename);
+
+        bool ExpandFile(std::string_view text, const ParsedFile& parsed, ExpansionState& state);
+
+        mutable std::mutex m_Mutex;
+
+        std::unordered_map<std::string, IncludeFilePtr> m_Includes;
+
+        // Filename of a shader source to the files it includes
+        std::unordered_map<std::string, std::set<std::string>> m_Dependencies;
+    };
+}
+
+#endif // VK_TESTS_RENDERER_SHADERINCLUDERESOLVER_HPP
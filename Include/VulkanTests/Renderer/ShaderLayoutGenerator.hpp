@@ -0,0 +1,39 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef VK_TESTS_RENDERER_SHADERLAYOUTGENERATOR_HPP
+#define VK_TESTS_RENDERER_SHADERLAYOUTGENERATOR_HPP
+
+#include <VulkanTests/pch.hpp>
+
+#include <VulkanTests/Renderer/SpirvReflection.hpp>
+
+namespace VkTests {
+    /**
+     * @brief Generates C++ declarations matching the memory layout of shader blocks.
+     *
+     * Each block becomes a struct whose members sit at the exact offsets of the block members, padding being
+     * explicit byte arrays, so a whole struct can be copied into a mapped buffer. Vectors and matrices are declared
+     * as arrays of their components, padded to their strides. Every offset and size is checked by a static_assert.
+     * Trailing runtime arrays are not declared, their offset and stride are exposed as constants instead.
+     */
+    class ShaderLayoutGenerator {
+    public:
+        ShaderLayoutGenerator() = delete;
+
+        /**
+         * @brief Generates a header declaring the given blocks.
+         * @param layouts The reflected block layouts. Blocks with the same name and layout are declared once,
+         *        blocks with the same name but different layouts get a numbered suffix.
+         * @param nameSpace The namespace of the declarations, empty for the global namespace.
+         * @return The source of the header.
+         */
+        [[nodiscard]] static std::string GenerateHeader(const std::vector<ShaderBlockLayout>& layouts,
+                                                        std::string_view nameSpace);
+    };
+}
+
+#endif // VK_TESTS_RENDERER_SHADERLAYOUTGENERATOR_HPP
@@ -0,0 +1,102 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef VK_TESTS_RENDERER_SHADERLIBRARY_HPP
+#define VK_TESTS_RENDERER_SHADERLIBRARY_HPP
+
+#include <VulkanTests/pch.hpp>
+
+#include <VulkanTests/Core/ThreadPool.hpp>
+
+#include <VulkanTests/Renderer/VulkanWrapper/ShaderModule.hpp>
+
+namespace VkTests {
+    /**
+     * @brief Loads shader modules in the background and keeps them around for later requests.
+     *
+     * Compilation and reflection run on a thread pool, so requesting a module never blocks. Completion callbacks
+     * are only ever invoked from DispatchCompletions(), on whichever thread calls it, usually the render thread.
+     * A module that failed to load is forgotten, the next request for it compiles it again.
+     */
+    class ShaderLibrary {
+    public:
+        using ShaderModulePtr = std::shared_ptr<ShaderModule>;
+
+        using ShaderModuleFuture = std::shared_future<ShaderModulePtr>;
+
+        /// Called with the loaded module, or nullptr if it failed to compile.
+        using CompletionCallback = std::function<void(const ShaderModulePtr&)>;
+
+        ShaderLibrary(Device& device, ThreadPool& threadPool);
+        ~ShaderLibrary() = default;
+
+        ShaderLibrary(const ShaderLibrary&) = delete;
+        ShaderLibrary(ShaderLibrary&&) = delete;
+
+        ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+        ShaderLibrary& operator=(ShaderLibrary&&) = delete;
+
+        /**
+         * @brief Requests a shader module. Only the first request for a given shader starts a compilation.
+         * @param stage The Vulkan shader stage flag.
+         * @param glslSource The GLSL source of the shader.
+         * @param entryPoint The entry point name of the shader.
+         * @param shaderVariant The shader variant.
+         * @param callback (Optional) Invoked by DispatchCompletions() once the module is ready.
+         * @return A future holding the module, it is ready right away if the module was already loaded.
+         */
+        ShaderModuleFuture Load(VkShaderStageFlagBits stage, const ShaderSource& glslSource,
+                                const std::string& entryPoint, const ShaderVariant& shaderVariant,
+                                CompletionCallback callback = {});
+
+        /**
+         * @brief Invokes the callbacks of every finished request on the calling thread.
+         * @return The number of callbacks invoked.
+         */
+        USize DispatchCompletions();
+
+        /**
+         * @brief Get the number of callbacks still waiting for their module.
+         */
+        [[nodiscard]] USize GetPendingCount() const;
+
+    private:
+        // Identifies a module by every part of its request, hashes only select the bucket
+        struct ModuleKey {
+            VkShaderStageFlagBits Stage;
+            std::string Filename;
+            Hash128 SourceId;
+            std::string EntryPoint;
+            Hash128 VariantId;
+
+            [[nodiscard]] bool operator==(const ModuleKey& other) const = default;
+        };
+
+        struct ModuleKeyHasher {
+            [[nodiscard]] USize operator()(const ModuleKey& key) const;
+        };
+
+        struct PendingCompletion {
+            ModuleKey Key;
+            ShaderModuleFuture Future;
+            CompletionCallback Callback;
+        };
+
+        // Forgets the module of a key if its load failed, the lock must be held
+        void EraseFailed(const ModuleKey& key);
+
+        Device& m_Device;
+        ThreadPool& m_ThreadPool;
+
+        mutable std::mutex m_Mutex;
+
+        std::unordered_map<ModuleKey, ShaderModuleFuture, ModuleKeyHasher> m_Modules;
+
+        std::vector<PendingCompletion> m_PendingCompletions;
+    };
+}
+
+#endif // VK_TESTS_RENDERER_SHADERLIBRARY_HPP
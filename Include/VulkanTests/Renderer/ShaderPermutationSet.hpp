@@ -0,0 +1,105 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef VK_TESTS_RENDERER_SHADERPERMUTATIONSET_HPP
+#define VK_TESTS_RENDERER_SHADERPERMUTATIONSET_HPP
+
+#include <VulkanTests/pch.hpp>
+
+#include <VulkanTests/Core/ThreadPool.hpp>
+
+#include <VulkanTests/Renderer/VulkanWrapper/ShaderModule.hpp>
+
+namespace VkTests {
+    /**
+     * @brief A define that varies across the permutations of a shader.
+     *        Without values, the define is either absent or defined, otherwise it is defined to each value in turn.
+     */
+    struct ShaderDefineAxis {
+        std::string Name;
+
+        std::vector<std::string> Values;
+    };
+
+    /**
+     * @brief The compilation results of every permutation of a ShaderPermutationSet.
+     */
+    struct ShaderPermutationResult {
+        /// One result per unique preprocessed source.
+        std::vector<ShaderCompileResult> Results;
+
+        /// For each permutation, the index of its result in Results.
+        std::vector<USize> ResultIndices;
+
+        [[nodiscard]] inline const ShaderCompileResult& Get(USize permutation) const;
+    };
+
+    /**
+     * @brief Enumerates the variants of a shader over the cartesian product of define axes, and compiles them.
+     *
+     * Many permutations usually collapse to the same code once preprocessed (a define that no code path of the shader
+     * tests, two options that cancel each other...). Every permutation is preprocessed, which is cheap, and only the
+     * ones with a distinct preprocessed source are compiled.
+     */
+    class ShaderPermutationSet {
+    public:
+        ShaderPermutationSet() = default;
+        ~ShaderPermutationSet() = default;
+
+        ShaderPermutationSet(const ShaderPermutationSet&) = default;
+        ShaderPermutationSet(ShaderPermutationSet&&) = default;
+
+        ShaderPermutationSet& operator=(const ShaderPermutationSet&) = default;
+        ShaderPermutationSet& operator=(ShaderPermutationSet&&) = default;
+
+        /**
+         * @brief Adds an axis whose define is either absent or defined.
+         * @param name The name of the define.
+         */
+        void AddAxis(const std::string& name);
+
+        /**
+         * @brief Adds an axis whose define takes each of the given values.
+         * @param name The name of the define.
+         * @param values The values of the define, must not be empty.
+         */
+        void AddAxis(const std::string& name, const std::vector<std::string>& values);
+
+        /**
+         * @brief Builds the variant of a permutation.
+         * @param permutation The index of the permutation, lower than GetPermutationCount().
+         * @param baseVariant The variant the axis defines are added to.
+         * @return The variant of the permutation.
+         */
+        [[nodiscard]] ShaderVariant GetVariant(USize permutation, const ShaderVariant& baseVariant = {}) const;
+
+        /**
+         * @brief Compiles every permutation of a shader, compiling each distinct preprocessed source only once.
+         * @param threadPool The thread pool to preprocess and compile on, not called from one of its workers.
+         * @param stage The Vulkan shader stage flag.
+         * @param glslSource The GLSL source of the shader.
+         * @param entryPoint The entry point name of the shader.
+         * @param baseVariant The variant the axis defines are added to.
+         * @return The results of every permutation.
+         */
+        [[nodiscard]] ShaderPermutationResult Compile(ThreadPool& threadPool, VkShaderStageFlagBits stage,
+                                                      const ShaderSource& glslSource, const std::string& entryPoint,
+                                                      const ShaderVariant& baseVariant = {}) const;
+
+        [[nodiscard]] inline const std::vector<ShaderDefineAxis>& GetAxes() const;
+
+        [[nodiscard]] inline USize GetPermutationCount() const;
+
+    private:
+        std::vector<ShaderDefineAxis> m_Axes;
+
+        USize m_PermutationCount{1};
+    };
+}
+
+#include <VulkanTests/Renderer/ShaderPermutationSet.inl>
+
+#endif // VK_TESTS_RENDERER_SHADERPERMUTATIONSET_HPP
@@ -0,0 +1,19 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#pragma once
+
+namespace VkTests {
+    inline const ShaderCompileResult& ShaderPermutationResult::Get(const USize permutation) const {
+        return Results[ResultIndices[permutation]];
+    }
+
+    inline const std::vector<ShaderDefineAxis>& ShaderPermutationSet::GetAxes() const {
+        return m_Axes;
+    }
+
+    inline USize ShaderPermutationSet::GetPermutationCount() const {
+        return m_PermutationCount;
+    }
+}
@@ -0,0 +1,91 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef VK_TESTS_RENDERER_SHADERPROGRAMLAYOUT_HPP
+#define VK_TESTS_RENDERER_SHADERPROGRAMLAYOUT_HPP
+
+#include <VulkanTests/pch.hpp>
+
+#include <VulkanTests/Renderer/VkCommon.hpp>
+#include <VulkanTests/Renderer/VulkanWrapper/ShaderModule.hpp>
+
+#include <VulkanTests/Utils/Hash.hpp>
+
+namespace VkTests {
+    /**
+     * @brief Merges the reflected resources of every stage of a program into the description of its pipeline layout.
+     *
+     * Descriptors are matched by set and binding, the other resources by name (and by stage for stage inputs and
+     * outputs). The stages of matching resources are combined. The push constant ranges are merged so that stages
+     * sharing the same range share a single VkPushConstantRange, as each stage may only appear in one range.
+     */
+    class ShaderProgramLayout {
+    public:
+        ShaderProgramLayout();
+        ~ShaderProgramLayout() = default;
+
+        ShaderProgramLayout(const ShaderProgramLayout&) = default;
+        ShaderProgramLayout(ShaderProgramLayout&&) = default;
+
+        ShaderProgramLayout& operator=(const ShaderProgramLayout&) = default;
+        ShaderProgramLayout& operator=(ShaderProgramLayout&&) = default;
+
+        /**
+         * @brief Merges the resources of a shader module into the layout.
+         * @param shaderModule The shader module of one of the stages of the program.
+         * @return False if a resource conflicts with one already in the layout, which is then left unchanged.
+         */
+        bool AddShaderModule(const ShaderModule& shaderModule);
+
+        /**
+         * @brief Merges reflected resources into the layout.
+         * @param resources The resources of one of the stages of the program.
+         * @return False if a resource conflicts with one already in the layout, which is then left unchanged.
+         */
+        bool AddResources(const std::vector<ShaderResource>& resources);
+
+        /**
+         * @brief Get the resources of every stage, with their stages combined.
+         */
+        [[nodiscard]] inline const std::vector<ShaderResource>& GetResources() const;
+
+        /**
+         * @brief Get the bindings of every descriptor set, sorted by binding.
+         */
+        [[nodiscard]] inline const std::map<UInt32, std::vector<VkDescriptorSetLayoutBinding>>& GetSetLayouts() const;
+
+        /**
+         * @brief Get the bindings of a descriptor set, sorted by binding. It is empty if no stage uses the set.
+         */
+        [[nodiscard]] const std::vector<VkDescriptorSetLayoutBinding>& GetSetLayoutBindings(UInt32 set) const;
+
+        [[nodiscard]] inline const std::vector<VkPushConstantRange>& GetPushConstantRanges() const;
+
+        /**
+         * @brief Get the hash of the descriptor set layouts and push constant ranges.
+         *        Programs with the same hash can share their pipeline layout.
+         */
+        [[nodiscard]] inline const Hash128& GetHash() const;
+
+    private:
+        void Update();
+
+        std::vector<ShaderResource> m_Resources;
+
+        // The [begin, end) range of the push constants of each stage
+        std::map<VkShaderStageFlags, std::pair<UInt32, UInt32>> m_PushConstantStages;
+
+        std::map<UInt32, std::vector<VkDescriptorSetLayoutBinding>> m_SetLayouts;
+
+        std::vector<VkPushConstantRange> m_PushConstantRanges;
+
+        Hash128 m_Hash;
+    };
+}
+
+#include <VulkanTests/Renderer/ShaderProgramLayout.inl>
+
+#endif // VK_TESTS_RENDERER_SHADERPROGRAMLAYOUT_HPP
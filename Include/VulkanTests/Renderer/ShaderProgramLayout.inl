@@ -0,0 +1,24 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#pragma once
+
+namespace VkTests {
+    inline const std::vector<ShaderResource>& ShaderProgramLayout::GetResources() const {
+        return m_Resources;
+    }
+
+    inline const std::map<UInt32, std::vector<VkDescriptorSetLayoutBinding>>&
+    ShaderProgramLayout::GetSetLayouts() const {
+        return m_SetLayouts;
+    }
+
+    inline const std::vector<VkPushConstantRange>& ShaderProgramLayout::GetPushConstantRanges() const {
+        return m_PushConstantRanges;
+    }
+
+    inline const Hash128& ShaderProgramLayout::GetHash() const {
+        return m_Hash;
+    }
+}
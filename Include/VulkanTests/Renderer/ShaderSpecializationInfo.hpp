@@ -0,0 +1,56 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef VK_TESTS_RENDERER_SHADERSPECIALIZATIONINFO_HPP
+#define VK_TESTS_RENDERER_SHADERSPECIALIZATIONINFO_HPP
+
+#include <VulkanTests/pch.hpp>
+
+#include <VulkanTests/Renderer/VkCommon.hpp>
+#include <VulkanTests/Renderer/VkInitializers.hpp>
+#include <VulkanTests/Renderer/VulkanWrapper/ShaderModule.hpp>
+
+namespace VkTests {
+    /**
+     * @brief The specialization constant values of a variant, laid out for a VkSpecializationInfo.
+     *
+     * Only the constants the module still declares get an entry, so a variant can be shared by every stage of a
+     * program, and a module whose constants were frozen gets an empty info.
+     */
+    class ShaderSpecializationInfo {
+    public:
+        ShaderSpecializationInfo() = default;
+
+        ShaderSpecializationInfo(const ShaderModule& shaderModule, const ShaderVariant& shaderVariant);
+
+        /**
+         * @param resources The reflected resources of the module, of which the specialization constants are used.
+         * @param shaderVariant The variant holding the values of the constants.
+         */
+        ShaderSpecializationInfo(const std::vector<ShaderResource>& resources, const ShaderVariant& shaderVariant);
+
+        /**
+         * @brief Get the info to give to VkPipelineShaderStageCreateInfo::pSpecializationInfo.
+         *        It points into this object, which must outlive its use.
+         */
+        [[nodiscard]] inline VkSpecializationInfo GetInfo() const;
+
+        [[nodiscard]] inline const std::vector<VkSpecializationMapEntry>& GetMapEntries() const;
+
+        [[nodiscard]] inline const std::vector<UInt8>& GetData() const;
+
+        [[nodiscard]] inline bool IsEmpty() const;
+
+    private:
+        std::vector<VkSpecializationMapEntry> m_MapEntries;
+
+        std::vector<UInt8> m_Data;
+    };
+}
+
+#include <VulkanTests/Renderer/ShaderSpecializationInfo.inl>
+
+#endif // VK_TESTS_RENDERER_SHADERSPECIALIZATIONINFO_HPP
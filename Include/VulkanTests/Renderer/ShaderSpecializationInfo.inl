@@ -0,0 +1,24 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#pragma once
+
+namespace VkTests {
+    inline VkSpecializationInfo ShaderSpecializationInfo::GetInfo() const {
+        return VkInitializers::SpecializationInfo(static_cast<UInt32>(m_MapEntries.size()), m_MapEntries.data(),
+                                                  m_Data.size(), m_Data.data());
+    }
+
+    inline const std::vector<VkSpecializationMapEntry>& ShaderSpecializationInfo::GetMapEntries() const {
+        return m_MapEntries;
+    }
+
+    inline const std::vector<UInt8>& ShaderSpecializationInfo::GetData() const {
+        return m_Data;
+    }
+
+    inline bool ShaderSpecializationInfo::IsEmpty() const {
+        return m_MapEntries.empty();
+    }
+}
@@ -0,0 +1,165 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef VK_TESTS_RENDERER_SHADERSTATS_HPP
+#define VK_TESTS_RENDERER_SHADERSTATS_HPP
+
+#include <VulkanTests/pch.hpp>
+
+#include <VulkanTests/Renderer/VkCommon.hpp>
+
+#include <VulkanTests/Utils/Hash.hpp>
+
+#include <atomic>
+#include <mutex>
+
+namespace VkTests {
+    /**
+     * @brief The timings and outcome of the compilation of one shader module.
+     */
+    struct ShaderCompileStats {
+        std::string Filename;
+        std::string EntryPoint;
+        VkShaderStageFlagBits Stage{};
+        Hash128 VariantId;
+
+        /// Expansion of the includes, the preprocessor directives are left to glslang.
+        std::chrono::nanoseconds IncludeExpansionTime{};
+
+        /// glslang parsing, its own preprocessing included.
+        std::chrono::nanoseconds ParseTime{};
+
+        std::chrono::nanoseconds LinkTime{};
+
+        /// Translation of the glslang intermediate tree to SPIR-V.
+        std::chrono::nanoseconds SpirvGenerationTime{};
+
+        /// spirv-tools passes run on the module: HLSL legalization, then the optimization the variant requests.
+        std::chrono::nanoseconds OptimizationTime{};
+
+        /// spirv-tools validation, 0 unless VK_TESTS_SHADER_VALIDATION is defined.
+        std::chrono::nanoseconds ValidationTime{};
+
+        std::chrono::nanoseconds ReflectionTime{};
+
+        /// The whole compilation, cache lookups included.
+        std::chrono::nanoseconds TotalTime{};
+
+        /// Size of the SPIR-V module in bytes.
+        USize OutputSize = 0;
+
+        /// Instructions of the SPIR-V module before and after the optimization passes, 0 if this compilation didn't
+        /// optimize it.
+        USize InstructionCountBefore = 0;
+        USize InstructionCountAfter = 0;
+
+        /// The SPIR-V came from the shader cache or the mounted archive, glslang didn't run.
+        bool CacheHit = false;
+
+        /// The resources came from the shader cache or the mounted archive, the module wasn't reflected.
+        bool ReflectionCacheHit = false;
+
+        bool Success = false;
+    };
+
+    /**
+     * @brief The statistics of every recorded compilation added together.
+     */
+    struct ShaderStatsSummary {
+        USize CompileCount = 0;
+        USize FailureCount = 0;
+        USize CacheHitCount = 0;
+        USize ReflectionCacheHitCount = 0;
+
+        std::chrono::nanoseconds IncludeExpansionTime{};
+        std::chrono::nanoseconds ParseTime{};
+        std::chrono::nanoseconds LinkTime{};
+        std::chrono::nanoseconds SpirvGenerationTime{};
+        std::chrono::nanoseconds OptimizationTime{};
+        std::chrono::nanoseconds ValidationTime{};
+        std::chrono::nanoseconds ReflectionTime{};
+        std::chrono::nanoseconds TotalTime{};
+
+        USize OutputSize = 0;
+        USize OptimizedCount = 0;
+        USize InstructionCountBefore = 0;
+        USize InstructionCountAfter = 0;
+    };
+
+    /**
+     * @brief Registry of the statistics of the shader compilations, to find the shaders dominating load times.
+     *        Compilations running on a ThreadPool may record their statistics concurrently.
+     *        Every compilation adds a record until Clear() is called, so recording is meant for tools and profiling
+     *        sessions. The statistics of a single compilation are always available in its ShaderCompileResult.
+     */
+    class ShaderStats {
+        static std::atomic<bool> m_SEnabled;
+
+    public:
+        ShaderStats() = delete;
+
+        /**
+         * @brief Enable or disable the recording of statistics. It is disabled by default.
+         */
+        static inline void SetEnabled(bool enabled);
+
+        [[nodiscard]] static inline bool IsEnabled();
+
+        /**
+         * @brief Records the statistics of a compilation, if recording is enabled.
+         */
+        static void Record(const ShaderCompileStats& stats);
+
+        /**
+         * @brief Get the statistics of every recorded compilation, in the order they were recorded.
+         */
+        [[nodiscard]] static std::vector<ShaderCompileStats> GetRecords();
+
+        /**
+         * @brief Get the statistics of the slowest recorded compilations, slowest first.
+         * @param count The maximum number of compilations to return.
+         */
+        [[nodiscard]] static std::vector<ShaderCompileStats> GetSlowest(USize count);
+
+        [[nodiscard]] static ShaderStatsSummary GetSummary();
+
+        /**
+         * @brief Logs the summary and the slowest compilations.
+         * @param count The number of slowest compilations to log.
+         */
+        static void LogSummary(USize count = 10);
+
+        static void Clear();
+
+    private:
+        static std::mutex m_SMutex;
+        static std::vector<ShaderCompileStats> m_SRecords;
+    };
+
+    /**
+     * @brief Adds the time spent in a scope to a duration, if any is given.
+     */
+    class ShaderStatsTimer {
+    public:
+        explicit ShaderStatsTimer(std::chrono::nanoseconds* duration);
+        ~ShaderStatsTimer();
+
+        ShaderStatsTimer(const ShaderStatsTimer&) = delete;
+        ShaderStatsTimer(ShaderStatsTimer&&) = delete;
+
+        ShaderStatsTimer& operator=(const ShaderStatsTimer&) = delete;
+        ShaderStatsTimer& operator=(ShaderStatsTimer&&) = delete;
+
+    private:
+        std::chrono::nanoseconds* m_Duration;
+
+        std::chrono::steady_clock::time_point m_Start;
+    };
+}
+
+#include <VulkanTests/Renderer/ShaderStats.inl>
+
+#endif // VK_TESTS_RENDERER_SHADERSTATS_HPP
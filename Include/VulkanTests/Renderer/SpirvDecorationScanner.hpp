@@ -0,0 +1,168 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef VK_TESTS_RENDERER_SPIRVDECORATIONSCANNER_HPP
+#define VK_TESTS_RENDERER_SPIRVDECORATIONSCANNER_HPP
+
+#include <VulkanTests/pch.hpp>
+
+#include <VulkanTests/Renderer/SpirvReflection.hpp>
+#include <VulkanTests/Renderer/VkCommon.hpp>
+#include <VulkanTests/Renderer/VulkanWrapper/ShaderModule.hpp>
+
+#include <spirv_cross/spirv.hpp>
+
+namespace VkTests {
+    /**
+     * @brief Reflects shader resources with a single pass over the declarations of a SPIR-V module.
+     *
+     * Only names, decorations, types, constants and global variables are decoded, the scan stops at the first
+     * function. The resources are the same, in the same order, as the ones SPIRV-Cross reflects.
+     */
+    class SpirvDecorationScanner {
+    public:
+        /**
+         * @brief Reflects shader resources from SPIR-V code.
+         * @param stage The Vulkan shader stage flag.
+         * @param spirv The SPIR-V code of the shader.
+         * @param[out] resources The list of reflected shader resources.
+         * @param variant ShaderVariant specifying the size of the runtime arrays in storage buffers.
+         * @return True if reflection was successful, false otherwise.
+         */
+        bool ReflectShaderResources(VkShaderStageFlagBits stage, const std::vector<UInt32>& spirv,
+                                    std::vector<ShaderResource>& resources, const ShaderVariant& variant);
+
+        /**
+         * @brief Reflects the member layout of the uniform, storage and push constant blocks of SPIR-V code.
+         * @param spirv The SPIR-V code of the shader.
+         * @param[out] layouts The layouts of the blocks, in the order their resources are reflected.
+         * @return True if reflection was successful, false otherwise.
+         */
+        bool ReflectBlockLayouts(const std::vector<UInt32>& spirv, std::vector<ShaderBlockLayout>& layouts);
+
+    private:
+        struct Decorations {
+            UInt32 Location{0};
+            UInt32 Binding{0};
+            UInt32 DescriptorSet{0};
+            UInt32 InputAttachmentIndex{0};
+            UInt32 SpecId{0};
+            UInt32 ArrayStride{0};
+            bool HasSpecId{false};
+            bool HasArrayStride{false};
+            bool Block{false};
+            bool BufferBlock{false};
+            bool BuiltIn{false};
+        };
+
+        struct MemberDecorations {
+            UInt32 Offset{0};
+            UInt32 MatrixStride{0};
+            bool HasOffset{false};
+            bool HasMatrixStride{false};
+            bool RowMajor{false};
+            bool ColMajor{false};
+            bool BuiltIn{false};
+        };
+
+        struct Type {
+            spv::Op Op{spv::OpNop};
+            UInt32 Width{0};    // Scalars
+            bool Signed{false}; // Integers
+            UInt32 Element{0};  // Component of vectors and matrices, element of arrays, pointee of pointers
+            UInt32 Count{0};    // Size of vectors, columns of matrices, length constant of arrays
+            UInt32 Sampled{0};  // Images
+            spv::Dim Dim{spv::Dim1D};
+            spv::StorageClass Storage{spv::StorageClassUniformConstant};
+            std::vector<UInt32> Members;
+        };
+
+        struct Constant {
+            UInt32 Type{0};
+            UInt32 Value{0};
+            bool Specialization{false};
+            bool Defined{false};
+        };
+
+        struct Variable {
+            UInt32 Id;
+            UInt32 Type;
+            spv::StorageClass Storage;
+        };
+
+        // An array dimension, as a literal length or as the id of the specialization constant sizing it
+        struct ArrayDimension {
+            UInt32 Length;
+            bool Literal;
+        };
+
+        // The descriptor and stage interface resources, bucketed by type
+        using ResourceLists = std::array<std::vector<ShaderResource>,
+                                         static_cast<USize>(ShaderResourceType::PushConstant)>;
+
+        bool Scan(const std::vector<UInt32>& spirv);
+
+        bool ReadVariable(const Variable& variable, VkShaderStageFlagBits stage, ResourceLists& lists,
+                          const ShaderVariant& variant) const;
+
+        bool ReadPushConstant(const Variable& variable, VkShaderStageFlagBits stage,
+                              std::vector<ShaderResource>& resources, const ShaderVariant& variant) const;
+
+        void ReadSpecializationConstant(UInt32 id, VkShaderStageFlagBits stage,
+                                        std::vector<ShaderResource>& resources) const;
+
+        bool ReadBlockMembers(UInt32 type, std::vector<ShaderBlockMember>& members) const;
+
+        [[nodiscard]] bool IsInEntryPointInterface(const Variable& variable) const;
+
+        [[nodiscard]] bool IsBuiltIn(const Variable& variable) const;
+
+        [[nodiscard]] bool IsSsboInstanceNameSignificant() const;
+
+        [[nodiscard]] std::string GetBlockName(const Variable& variable, bool preferInstanceName) const;
+
+        [[nodiscard]] const std::string& GetName(UInt32 id) const;
+
+        [[nodiscard]] const std::string& GetMemberName(UInt32 type, UInt32 index) const;
+
+        [[nodiscard]] ShaderBaseType GetScalarType(UInt32 type) const;
+
+        // Strips the arrays off a type, optionally gathering their dimensions, innermost first as SPIRV-Cross does
+        [[nodiscard]] UInt32 GetBaseType(UInt32 type, std::vector<ArrayDimension>* dimensions = nullptr) const;
+
+        [[nodiscard]] UInt32 GetArraySize(UInt32 type) const;
+
+        bool GetStructSize(UInt32 type, USize runtimeArraySize, UInt32& size) const;
+
+        bool GetMemberSize(UInt32 type, UInt32 index, UInt32& size) const;
+
+        bool GetMemberArrayStride(UInt32 type, UInt32 index, UInt32& stride) const;
+
+        [[nodiscard]] const MemberDecorations& GetMemberDecorations(UInt32 type, UInt32 index) const;
+
+        [[nodiscard]] UInt32 GetConstantValue(UInt32 id) const;
+
+        [[nodiscard]] UInt32 GetConstantSize(UInt32 id) const;
+
+        UInt32 m_Version{0};
+        UInt32 m_SourceLanguage{spv::SourceLanguageUnknown};
+        bool m_SourceKnown{false};
+        std::vector<UInt32> m_Interface;
+
+        // Indexed by id
+        std::vector<std::string> m_Names;
+        std::vector<Decorations> m_Decorations;
+        std::vector<Type> m_Types;
+        std::vector<Constant> m_Constants;
+
+        std::unordered_map<UInt32, std::vector<MemberDecorations>> m_MemberDecorations;
+        std::unordered_map<UInt32, std::vector<std::string>> m_MemberNames;
+        std::vector<Variable> m_Variables;
+        std::vector<UInt32> m_SpecializationConstants;
+    };
+}
+
+#endif // VK_TESTS_RENDERER_SPIRVDECORATIONSCANNER_HPP
@@ -0,0 +1,61 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef VK_TESTS_RENDERER_SPIRVOPTIMIZER_HPP
+#define VK_TESTS_RENDERER_SPIRVOPTIMIZER_HPP
+
+#include <VulkanTests/pch.hpp>
+
+#include <VulkanTests/Renderer/VulkanWrapper/ShaderModule.hpp>
+
+#include <spirv-tools/libspirv.h>
+
+namespace VkTests {
+    /**
+     * @brief Post-processes the SPIR-V generated for a shader variant, as configured by the variant:
+     *        spirv-tools optimization passes, debug information stripping and id remapping.
+     */
+    class SpirvOptimizer {
+    public:
+        SpirvOptimizer() = delete;
+
+        /**
+         * @brief Checks whether a variant requests any post-processing.
+         */
+        [[nodiscard]] static bool IsEnabled(const ShaderVariant& shaderVariant);
+
+        /**
+         * @brief Optimizes a SPIR-V module in place. The module is left untouched if the optimization fails.
+         * @param targetEnvironment The environment the module targets.
+         * @param shaderVariant The shader variant holding the post-processing settings.
+         * @param[in,out] spirv The SPIR-V code to optimize.
+         * @param[out] infoLog Stores any message emitted by the optimizer.
+         * @param[out] stats (Optional) Receives the instruction counts of the module before and after the
+         *        optimization.
+         * @return True if the optimization was successful, false otherwise.
+         */
+        static bool Optimize(spv_target_env targetEnvironment, const ShaderVariant& shaderVariant,
+                             std::vector<UInt32>& spirv, std::string& infoLog, ShaderCompileStats* stats = nullptr);
+
+        /**
+         * @brief Runs the spirv-tools legalization passes on a module generated from HLSL, which glslang may emit
+         *        in a form Vulkan doesn't accept (resources stored in local variables or structs, for instance).
+         *        The module is left untouched if the legalization fails.
+         * @param targetEnvironment The environment the module targets.
+         * @param[in,out] spirv The SPIR-V code to legalize.
+         * @param[out] infoLog Stores any message emitted by the optimizer.
+         * @return True if the legalization was successful, false otherwise.
+         */
+        static bool Legalize(spv_target_env targetEnvironment, std::vector<UInt32>& spirv, std::string& infoLog);
+
+        /**
+         * @brief Counts the instructions of a SPIR-V module.
+         */
+        [[nodiscard]] static USize CountInstructions(const std::vector<UInt32>& spirv);
+    };
+}
+
+#endif // VK_TESTS_RENDERER_SPIRVOPTIMIZER_HPP
@@ -13,12 +13,80 @@
 #include <VulkanTests/Renderer/VkCommon.hpp>
 #include <VulkanTests/Renderer/VulkanWrapper/ShaderModule.hpp>
 
-#include <spirv_cross/spirv_glsl.hpp>
+#include <spirv_cross/spirv_cross.hpp>
+
+#include <atomic>
 
 namespace VkTests {
+    /// The implementation reflecting shader resources, both produce the same resources.
+    enum class SpirvReflectionBackend {
+        /// Builds the full SPIRV-Cross intermediate representation of the module.
+        SpirvCross,
+        /// Decodes only the declarations of the module in a single pass, see SpirvDecorationScanner.
+        DecorationScanner
+    };
+
+    /// The scalar type of a block member.
+    enum class ShaderBaseType : UInt8 {
+        Unknown,
+        Bool,
+        Int,
+        UInt,
+        Int64,
+        UInt64,
+        Half,
+        Float,
+        Double,
+        Struct
+    };
+
+    /// A member of a uniform, storage or push constant block, with its explicit layout.
+    struct ShaderBlockMember {
+        std::string Name;
+        /// The name of the struct type of struct members.
+        std::string TypeName;
+        ShaderBaseType BaseType;
+        UInt32 Offset;
+        /// The size of the member, arrays included. Runtime arrays have a size of 0.
+        UInt32 Size;
+        UInt32 VecSize;
+        UInt32 Columns;
+        /// The length of each array dimension, outermost first. Runtime arrays have a length of 0.
+        std::vector<UInt32> ArrayDimensions;
+        /// The stride of each array dimension, outermost first.
+        std::vector<UInt32> ArrayStrides;
+        UInt32 MatrixStride;
+        bool RowMajor;
+        /// The members of struct members.
+        std::vector<ShaderBlockMember> Members;
+    };
+
+    /// The memory layout of a uniform, storage or push constant block.
+    struct ShaderBlockLayout {
+        /// BufferUniform, BufferStorage or PushConstant.
+        ShaderResourceType Type;
+        /// The name of the block, as reported for its ShaderResource.
+        std::string Name;
+        std::string TypeName;
+        UInt32 Set;
+        UInt32 Binding;
+        /// The size of the block, without the elements of a trailing runtime array.
+        UInt32 Size;
+        std::vector<ShaderBlockMember> Members;
+    };
+
     /// Generate a list of shader resources based on SPIR-V reflection code, and provided ShaderVariant.
     class SpirvReflection {
+        static std::atomic<SpirvReflectionBackend> m_SBackend;
+
     public:
+        /// @brief Selects the backend used by every reflection, the decoration scanner by default. Reflections already
+        ///        running on other threads keep the backend they started with.
+        /// @param backend The reflection backend
+        static inline void SetBackend(SpirvReflectionBackend backend);
+
+        [[nodiscard]] static inline SpirvReflectionBackend GetBackend();
+
         /// @brief Reflects shader resources from SPIRV code
         /// @param stage The Vulkan shader stage flag
         /// @param spirv The SPIRV code of shader
@@ -28,16 +96,42 @@ namespace VkTests {
         bool ReflectShaderResources(VkShaderStageFlagBits stage, const std::vector<UInt32>& spirv,
                                     std::vector<ShaderResource>& resources, const ShaderVariant& variant);
 
+        /// @brief Reflects the member layout of the uniform, storage and push constant blocks of SPIRV code
+        /// @param spirv The SPIRV code of shader
+        /// @param[out] layouts The layouts of the blocks, in the order their resources are reflected, left untouched
+        /// on failure
+        /// @return True if reflection was successful, false otherwise
+        static bool ReflectBlockLayouts(const std::vector<UInt32>& spirv, std::vector<ShaderBlockLayout>& layouts);
+
+        /// @brief Serializes shader resources into a compact binary record
+        /// @param resources The shader resources to serialize
+        /// @return The serialized record
+        static std::vector<UInt8> SerializeResources(const std::vector<ShaderResource>& resources);
+
+        /// @brief Reads shader resources back from a record written by SerializeResources()
+        /// @param data The serialized record
+        /// @param size The size of the record in bytes
+        /// @param[out] resources The deserialized shader resources
+        /// @return True if the record is well-formed, false otherwise
+        static bool DeserializeResources(const UInt8* data, USize size, std::vector<ShaderResource>& resources);
+
     private:
-        static void ParseShaderResources(const spirv_cross::Compiler& compiler, VkShaderStageFlagBits stage,
-                                         std::vector<ShaderResource>& resources, const ShaderVariant& variant);
+        static void ParseShaderResources(const spirv_cross::Compiler& compiler,
+                                         const spirv_cross::ShaderResources& allResources,
+                                         VkShaderStageFlagBits stage, std::vector<ShaderResource>& resources,
+                                         const ShaderVariant& variant);
 
-        static void ParsePushConstants(const spirv_cross::Compiler& compiler, VkShaderStageFlagBits stage,
+        static void ParsePushConstants(const spirv_cross::Compiler& compiler,
+                                       const spirv_cross::ShaderResources& allResources, VkShaderStageFlagBits stage,
                                        std::vector<ShaderResource>& resources, const ShaderVariant& variant);
 
-        static void ParseSpecializationConstants(const spirv_cross::Compiler& compiler, VkShaderStageFlagBits stage,
-                                                 std::vector<ShaderResource>& resources, const ShaderVariant& variant);
+        static void ParseSpecializationConstants(
+            const spirv_cross::Compiler& compiler,
+            const spirv_cross::SmallVector<spirv_cross::SpecializationConstant>& specializationConstants,
+            VkShaderStageFlagBits stage, std::vector<ShaderResource>& resources, const ShaderVariant& variant);
     };
 }
 
+#include <VulkanTests/Renderer/SpirvReflection.inl>
+
 #endif // VK_TESTS_RENDERER_SPIRVREFLECTION_HPP
@@ -0,0 +1,15 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#pragma once
+
+namespace VkTests {
+    inline void SpirvReflection::SetBackend(const SpirvReflectionBackend backend) {
+        m_SBackend.store(backend, std::memory_order_relaxed);
+    }
+
+    inline SpirvReflectionBackend SpirvReflection::GetBackend() {
+        return m_SBackend.load(std::memory_order_relaxed);
+    }
+}
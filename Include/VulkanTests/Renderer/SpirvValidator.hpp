@@ -0,0 +1,39 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef VK_TESTS_RENDERER_SPIRVVALIDATOR_HPP
+#define VK_TESTS_RENDERER_SPIRVVALIDATOR_HPP
+
+#include <VulkanTests/pch.hpp>
+
+#include <VulkanTests/Renderer/VulkanWrapper/ShaderModule.hpp>
+
+#include <spirv-tools/libspirv.h>
+
+namespace VkTests {
+    /**
+     * @brief Validates SPIR-V modules with spirv-tools, so that invalid code is caught before reaching the driver.
+     *        GlslCompiler only runs it when the shader-validation option is enabled, which it is in debug builds.
+     */
+    class SpirvValidator {
+    public:
+        SpirvValidator() = delete;
+
+        /**
+         * @brief Validates a SPIR-V module.
+         * @param targetEnvironment The environment the module targets.
+         * @param spirv The SPIR-V code to validate.
+         * @param[out] infoLog Stores the validator messages.
+         * @param[out] diagnostics Stores the validator messages, with their severity and SPIR-V word. Their source
+         *             location is only known if the module carries OpLine debug information.
+         * @return True if the module is valid, false otherwise.
+         */
+        static bool Validate(spv_target_env targetEnvironment, const std::vector<UInt32>& spirv, std::string& infoLog,
+                             std::vector<ShaderDiagnostic>& diagnostics);
+    };
+}
+
+#endif // VK_TESTS_RENDERER_SPIRVVALIDATOR_HPP
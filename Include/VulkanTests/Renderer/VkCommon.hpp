@@ -113,13 +113,22 @@ namespace VkTests {
 		Hlsl
 	};
 
+	/**
+	 * @brief Deduces the stage of a shader from the extension of its file, such as ".frag". HLSL shaders carry the
+	 *        stage extension before their own, such as "Lighting.frag.hlsl".
+	 * @param path The shader location
+	 * @return The shader stage, or nothing if the extension doesn't name one
+	 */
+	std::optional<VkShaderStageFlagBits> FindShaderStage(const std::filesystem::path& path);
+
 	/**
 	 * @brief Helper function to create a VkShaderModule.
-	 * @param filename The shader location
+	 *        Sources are compiled with their "main" entry point through the shader cache, like any ShaderModule.
+	 * @param filename The shader location, relative to the shaders directory
 	 * @param device The logical device
 	 * @param stage The shader stage
-	 * @param srcLanguage The shader language
-	 * @return The shader module
+	 * @param srcLanguage The shader language, used when the extension is neither .spv nor .hlsl
+	 * @return The shader module, throws a VulkanException if it can't be compiled
 	 */
 	VkShaderModule LoadShader(const std::string& filename, VkDevice device, VkShaderStageFlagBits stage,
 	                          ShaderSourceLanguage srcLanguage = ShaderSourceLanguage::Glsl);
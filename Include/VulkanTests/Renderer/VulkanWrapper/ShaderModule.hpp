@@ -9,12 +9,20 @@
 
 #include <VulkanTests/pch.hpp>
 
+#include <VulkanTests/Renderer/ShaderStats.hpp>
 #include <VulkanTests/Renderer/VkCommon.hpp>
 
+#include <VulkanTests/Core/ThreadPool.hpp>
+
+#include <VulkanTests/Utils/Hash.hpp>
+
 #include <spirv_cross/spirv_cross.hpp>
 
+#include <cstring>
+
 namespace VkTests {
     class Device;
+    class GlslangSession;
 
     /// Types of shader resources
     enum class ShaderResourceType : UInt8 {
@@ -67,6 +75,23 @@ namespace VkTests {
         std::string Name;
     };
 
+    /**
+     * @brief How the SPIR-V generated for a shader variant is optimized.
+     */
+    enum class ShaderOptimizationLevel : UInt8 {
+        None,
+        Size,
+        Performance
+    };
+
+    /**
+     * @brief The value given to a specialization constant, as the bits of a 32 or 64-bit scalar.
+     */
+    struct ShaderSpecializationValue {
+        UInt64 Bits;
+        UInt32 Size;
+    };
+
     /**
      * @brief Adds support for C-style preprocessor macros to glsl shaders
      *        enabling definitions and un-definitions of certain symbols.
@@ -77,7 +102,7 @@ namespace VkTests {
 
         ShaderVariant(std::string&& preamble, std::vector<std::string>&& processes);
 
-        [[nodiscard]] inline USize GetId() const;
+        [[nodiscard]] inline const Hash128& GetId() const;
 
         /**
          * @brief Add definitions to the shader variant.
@@ -105,7 +130,39 @@ namespace VkTests {
          */
         void AddRuntimeArraySize(const std::string& runtimeArrayName, USize size);
 
-        inline void SetRuntimeArraySizes(const std::unordered_map<std::string, USize>& sizes);
+        void SetRuntimeArraySizes(const std::unordered_map<std::string, USize>& sizes);
+
+        /**
+         * @brief Sets the spirv-tools optimization passes run on the generated SPIR-V. Defaults to none.
+         */
+        void SetOptimizationLevel(ShaderOptimizationLevel level);
+
+        /**
+         * @brief Strips the debug instructions (names, source, line information) from the generated SPIR-V.
+         */
+        void SetStripDebugInfo(bool strip);
+
+        /**
+         * @brief Canonicalizes the ids of the generated SPIR-V and removes dead code, so that modules
+         *        which only differ by their id numbering become identical and compress better.
+         */
+        void SetRemap(bool remap);
+
+        /**
+         * @brief Sets the value of a specialization constant, overriding the default declared in the shader.
+         *        Booleans are stored as VkBool32, the other values must be 32 or 64-bit scalars.
+         * @param constantId The constant_id of the specialization constant.
+         * @param value The value of the constant, its size must match the size of the constant in the shader.
+         */
+        template <typename T>
+        void SetSpecializationConstant(UInt32 constantId, T value);
+
+        /**
+         * @brief Bakes the specialization constant values into the generated SPIR-V, turning every specialization
+         *        constant into a regular constant (those without a value keep their default) and removing the
+         *        code they disable. The module then has no specialization constant left to specialize.
+         */
+        void SetFreezeSpecializationConstants(bool freeze);
 
         [[nodiscard]] inline const std::string& GetPreamble() const;
 
@@ -113,10 +170,23 @@ namespace VkTests {
 
         [[nodiscard]] inline const std::unordered_map<std::string, USize>& GetRuntimeArraySizes() const;
 
+        [[nodiscard]] inline ShaderOptimizationLevel GetOptimizationLevel() const;
+
+        [[nodiscard]] inline bool GetStripDebugInfo() const;
+
+        [[nodiscard]] inline bool GetRemap() const;
+
+        [[nodiscard]] inline const std::map<UInt32, ShaderSpecializationValue>& GetSpecializationConstants() const;
+
+        [[nodiscard]] inline bool GetFreezeSpecializationConstants() const;
+
+        /**
+         * @brief Resets every setting of the variant to its default, and updates its id.
+         */
         void Clear();
 
     private:
-        USize m_Id;
+        Hash128 m_Id;
 
         std::string m_Preamble;
 
@@ -124,6 +194,17 @@ namespace VkTests {
 
         std::unordered_map<std::string, USize> m_RuntimeArraySizes;
 
+        ShaderOptimizationLevel m_OptimizationLevel{ShaderOptimizationLevel::None};
+
+        bool m_StripDebugInfo{false};
+
+        bool m_Remap{false};
+
+        // Ordered by constant id, so that the id of the variant doesn't depend on the order of the calls
+        std::map<UInt32, ShaderSpecializationValue> m_SpecializationConstants;
+
+        bool m_FreezeSpecializationConstants{false};
+
         void UpdateId();
     };
 
@@ -131,9 +212,15 @@ namespace VkTests {
     public:
         ShaderSource() = default;
 
+        /**
+         * @param filename The shader location, relative to the shaders directory.
+         *        Files with the .hlsl extension are compiled as HLSL, any other as GLSL.
+         *        If the file doesn't exist, the source is left empty and the shader can only be loaded from the
+         *        mounted ShaderArchive.
+         */
         explicit ShaderSource(const std::string& filename);
 
-        [[nodiscard]] inline USize GetId() const;
+        [[nodiscard]] inline const Hash128& GetId() const;
 
         [[nodiscard]] inline const std::string& GetFilename() const;
 
@@ -141,12 +228,91 @@ namespace VkTests {
 
         [[nodiscard]] inline const std::string& GetSource() const;
 
+        /**
+         * @brief Overrides the language deduced from the extension of the file.
+         */
+        inline void SetLanguage(ShadingLanguage language);
+
+        [[nodiscard]] inline ShadingLanguage GetLanguage() const;
+
     private:
-        USize m_Id;
+        Hash128 m_Id;
 
         std::string m_Filename;
 
         std::string m_Source;
+
+        ShadingLanguage m_Language{ShadingLanguage::Glsl};
+
+        void UpdateId();
+    };
+
+    /**
+     * @brief A shader source with its includes expanded.
+     *
+     * The whole text lives in a single buffer, split in segments that each come from one file,
+     * so it can be handed to glslang without further copies while keeping per-file diagnostics.
+     */
+    struct ExpandedShaderSource {
+        struct Segment {
+            USize Offset;
+            USize Length;
+            UInt32 File;
+        };
+
+        std::string Buffer;
+
+        std::vector<Segment> Segments;
+
+        /// Names of the files the segments come from, the shader source itself comes first.
+        std::vector<std::string> Files;
+
+        /// The language of the shader source, which its includes share.
+        ShadingLanguage Language{ShadingLanguage::Glsl};
+    };
+
+    enum class ShaderDiagnosticSeverity {
+        Info,
+        Warning,
+        Error
+    };
+
+    /**
+     * @brief A message emitted while compiling or validating a shader.
+     */
+    struct ShaderDiagnostic {
+        /// The file the message refers to, empty if unknown.
+        std::string File;
+
+        /// The line the message refers to, 0 if unknown.
+        UInt32 Line = 0;
+
+        /// The word of the SPIR-V module the message refers to, for the validator messages, 0 otherwise.
+        USize WordIndex = 0;
+
+        ShaderDiagnosticSeverity Severity = ShaderDiagnosticSeverity::Error;
+
+        std::string Message;
+    };
+
+    /**
+     * @brief Output of the compilation of a shader: its SPIR-V code and reflected resources.
+     */
+    struct ShaderCompileResult {
+        bool Success = false;
+
+        std::vector<UInt32> Spirv;
+
+        std::vector<ShaderResource> Resources;
+
+        /// The raw log of every compilation step.
+        std::string InfoLog;
+
+        /// The messages of the compiler and validator, with their location.
+        std::vector<ShaderDiagnostic> Diagnostics;
+
+        /// The timings of the compilation, also recorded in the ShaderStats registry.
+        ShaderCompileStats Stats;
     };
 
     /**
@@ -171,7 +337,38 @@ namespace VkTests {
 
         ShaderModule& operator=(ShaderModule&&) = delete;
 
-        [[nodiscard]] inline USize GetId() const;
+        /**
+         * @brief Creates a shader module on a worker of the thread pool, without blocking the caller.
+         * @param device The device the module is created for. The task holds a reference to it, it must outlive the
+         *        returned future.
+         * @param threadPool The thread pool to compile on.
+         * @param stage The Vulkan shader stage flag.
+         * @param glslSource The GLSL source of the shader.
+         * @param entryPoint The entry point name of the shader.
+         * @param shaderVariant The shader variant.
+         * @return A future holding the module, or the exception thrown if compilation failed.
+         */
+        [[nodiscard]] static std::future<ShaderModule> CreateAsync(Device& device, ThreadPool& threadPool,
+                                                                   VkShaderStageFlagBits stage,
+                                                                   const ShaderSource& glslSource,
+                                                                   const std::string& entryPoint,
+                                                                   const ShaderVariant& shaderVariant);
+
+        /**
+         * @brief Compiles a shader to SPIR-V and reflects its resources, without creating a module.
+         *        A shader whose source isn't on disk is loaded from the mounted ShaderArchive instead.
+         *        This function is thread-safe.
+         * @param stage The Vulkan shader stage flag.
+         * @param glslSource The GLSL source of the shader.
+         * @param entryPoint The entry point name of the shader.
+         * @param shaderVariant The shader variant.
+         * @return The compilation result, Success is false if compilation or reflection failed.
+         */
+        [[nodiscard]] static ShaderCompileResult Compile(VkShaderStageFlagBits stage, const ShaderSource& glslSource,
+                                                         const std::string& entryPoint,
+                                                         const ShaderVariant& shaderVariant);
+
+        [[nodiscard]] inline const Hash128& GetId() const;
 
         [[nodiscard]] inline VkShaderStageFlagBits GetStage() const;
 
@@ -181,12 +378,21 @@ namespace VkTests {
 
         [[nodiscard]] inline const std::string& GetInfoLog() const;
 
+        [[nodiscard]] inline const std::vector<ShaderDiagnostic>& GetDiagnostics() const;
+
         [[nodiscard]] inline const std::vector<UInt32>& GetBinary() const;
 
         [[nodiscard]] inline const std::string& GetDebugName() const;
 
         inline void SetDebugName(const std::string& name);
 
+        /**
+         * @brief Replaces the code and resources of the module with a new compilation of the same shader.
+         *        The modes set with SetResourceMode() are applied to the new resources.
+         * @param result A successful compilation result.
+         */
+        void Reload(ShaderCompileResult&& result);
+
         /**
          * @brief Flags a resource to use a different method of being bound to the shader
          * @param resourceName The name of the shader resource
@@ -195,9 +401,14 @@ namespace VkTests {
         void SetResourceMode(const std::string& resourceName, const ShaderResourceMode& mode);
 
     private:
+        void ApplyResourceMode(const std::string& resourceName, ShaderResourceMode mode);
+
         Device& m_Device;
 
-        USize m_Id;
+        // Shared by all modules, so glslang isn't initialized and finalized again for every shader.
+        std::shared_ptr<GlslangSession> m_GlslangSession;
+
+        Hash128 m_Id;
 
         VkShaderStageFlagBits m_Stage{};
 
@@ -210,6 +421,11 @@ namespace VkTests {
         std::vector<ShaderResource> m_Resources;
 
         std::string m_InfoLog;
+
+        std::vector<ShaderDiagnostic> m_Diagnostics;
+
+        // The modes set by SetResourceMode(), kept to be applied again on reload
+        std::unordered_map<std::string, ShaderResourceMode> m_ResourceModes;
     };
 }
 
@@ -5,14 +5,10 @@
 #pragma once
 
 namespace VkTests {
-    inline USize ShaderVariant::GetId() const {
+    inline const Hash128& ShaderVariant::GetId() const {
         return m_Id;
     }
 
-    inline void ShaderVariant::SetRuntimeArraySizes(const std::unordered_map<std::string, USize>& sizes) {
-        m_RuntimeArraySizes = sizes;
-    }
-
     inline const std::string& ShaderVariant::GetPreamble() const {
         return m_Preamble;
     }
@@ -25,7 +21,48 @@ namespace VkTests {
         return m_RuntimeArraySizes;
     }
 
-    inline USize ShaderSource::GetId() const {
+    inline ShaderOptimizationLevel ShaderVariant::GetOptimizationLevel() const {
+        return m_OptimizationLevel;
+    }
+
+    inline bool ShaderVariant::GetStripDebugInfo() const {
+        return m_StripDebugInfo;
+    }
+
+    inline bool ShaderVariant::GetRemap() const {
+        return m_Remap;
+    }
+
+    template <typename T>
+    void ShaderVariant::SetSpecializationConstant(const UInt32 constantId, const T value) {
+        static_assert(std::is_arithmetic_v<T>, "Specialization constants are scalars");
+
+        ShaderSpecializationValue specializationValue{};
+
+        if constexpr (std::is_same_v<T, bool>) {
+            specializationValue.Bits = value ? VK_TRUE : VK_FALSE;
+            specializationValue.Size = sizeof(VkBool32);
+        } else {
+            static_assert(sizeof(T) == 4 || sizeof(T) == 8, "Specialization constants are 32 or 64-bit scalars");
+
+            std::memcpy(&specializationValue.Bits, &value, sizeof(T));
+            specializationValue.Size = sizeof(T);
+        }
+
+        m_SpecializationConstants[constantId] = specializationValue;
+
+        UpdateId();
+    }
+
+    inline const std::map<UInt32, ShaderSpecializationValue>& ShaderVariant::GetSpecializationConstants() const {
+        return m_SpecializationConstants;
+    }
+
+    inline bool ShaderVariant::GetFreezeSpecializationConstants() const {
+        return m_FreezeSpecializationConstants;
+    }
+
+    inline const Hash128& ShaderSource::GetId() const {
         return m_Id;
     }
 
@@ -35,15 +72,23 @@ namespace VkTests {
 
     inline void ShaderSource::SetSource(const std::string& source) {
         m_Source = source;
-        constexpr std::hash<std::string> hasher{};
-        m_Id = hasher(std::string{m_Source.cbegin(), m_Source.cend()});
+        UpdateId();
     }
 
     inline const std::string& ShaderSource::GetSource() const {
         return m_Source;
     }
 
-    [[nodiscard]] inline USize ShaderModule::GetId() const {
+    inline void ShaderSource::SetLanguage(const ShadingLanguage language) {
+        m_Language = language;
+        UpdateId();
+    }
+
+    inline ShadingLanguage ShaderSource::GetLanguage() const {
+        return m_Language;
+    }
+
+    [[nodiscard]] inline const Hash128& ShaderModule::GetId() const {
         return m_Id;
     }
 
@@ -63,6 +108,10 @@ namespace VkTests {
         return m_InfoLog;
     }
 
+    [[nodiscard]] inline const std::vector<ShaderDiagnostic>& ShaderModule::GetDiagnostics() const {
+        return m_Diagnostics;
+    }
+
     [[nodiscard]] inline const std::vector<UInt32>& ShaderModule::GetBinary() const {
         return m_Spirv;
     }
@@ -9,6 +9,12 @@
 
 #include <VulkanTests/pch.hpp>
 
+#include <span>
+
+// Exposes XXH3_state_t, so that a StreamHasher doesn't need a heap allocation
+#define XXH_STATIC_LINKING_ONLY
+#include <xxhash.h>
+
 namespace VkTests {
 	inline void HashCombine(USize& seed, USize hash);
 
@@ -18,8 +24,91 @@ namespace VkTests {
 	 */
 	template <class T>
 	void HashCombine(USize& seed, const T& value);
+
+	/**
+	 * @brief A 128-bit hash, stable across runs, compilers and platforms.
+	 */
+	struct Hash128 {
+		UInt64 Low = 0;
+		UInt64 High = 0;
+
+		[[nodiscard]] bool operator==(const Hash128& other) const = default;
+
+		/**
+		 * @brief Formats the hash as 32 hexadecimal digits, suitable for file names.
+		 */
+		[[nodiscard]] inline std::string ToString() const;
+	};
+
+	/**
+	 * @brief Computes a 128-bit XXH3 hash incrementally, from data fed in any number of pieces.
+	 *        Data is hashed in place, it is never copied.
+	 */
+	class StreamHasher {
+	public:
+		explicit inline StreamHasher(UInt64 seed = 0);
+		~StreamHasher() = default;
+
+		StreamHasher(const StreamHasher&) = delete;
+		StreamHasher(StreamHasher&&) = delete;
+
+		StreamHasher& operator=(const StreamHasher&) = delete;
+		StreamHasher& operator=(StreamHasher&&) = delete;
+
+		inline void Update(const void* data, USize size);
+
+		/**
+		 * @brief Hashes the size of the string, then its characters.
+		 *        The size prevents consecutive strings from colliding by moving characters between them.
+		 */
+		inline void Update(std::string_view str);
+
+		template <typename T>
+		void Update(std::span<T> values);
+
+		template <typename T>
+		void UpdateValue(const T& value);
+
+		[[nodiscard]] inline Hash128 Digest() const;
+
+	private:
+		XXH3_state_t m_State;
+	};
+
+	/**
+	 * @brief Computes a 128-bit XXH3 hash of a byte range.
+	 * @param data The data to hash.
+	 * @param size The size of the data in bytes.
+	 * @param seed (Optional) The seed of the hash.
+	 * @return The hash of the data.
+	 */
+	[[nodiscard]] inline Hash128 ComputeHash128(const void* data, USize size, UInt64 seed = 0);
+
+	[[nodiscard]] inline Hash128 ComputeHash128(std::string_view str, UInt64 seed = 0);
+
+	template <typename T>
+	[[nodiscard]] Hash128 ComputeHash128(std::span<T> values, UInt64 seed = 0);
+
+	/**
+	 * @brief Computes a 64-bit XXH3 hash of a byte range.
+	 *        Unlike std::hash, the result is stable across runs and compilers.
+	 * @param data The data to hash.
+	 * @param size The size of the data in bytes.
+	 * @param seed (Optional) The seed of the hash, allows chaining the hashes of several ranges.
+	 * @return The hash of the data.
+	 */
+	[[nodiscard]] inline UInt64 StableHash(const void* data, USize size, UInt64 seed = 0);
+
+	[[nodiscard]] inline UInt64 StableHash(std::string_view str, UInt64 seed = 0);
 }
 
+template <>
+struct std::hash<VkTests::Hash128> {
+	VkTests::USize operator()(const VkTests::Hash128& hash) const noexcept {
+		return static_cast<VkTests::USize>(hash.Low);
+	}
+};
+
 #include <VulkanTests/Utils/Hash.inl>
 
 #endif // VK_TESTS_UTILS_HASH_HPP
@@ -16,4 +16,71 @@ namespace VkTests {
 
 		HashCombine(seed, hasher(value));
 	}
+
+	inline std::string Hash128::ToString() const {
+		constexpr char digits[] = "0123456789ABCDEF";
+
+		std::string str(32, '0');
+		for (USize i = 0; i < 16; ++i) {
+			str[15 - i] = digits[(High >> (i * 4)) & 0xF];
+			str[31 - i] = digits[(Low >> (i * 4)) & 0xF];
+		}
+
+		return str;
+	}
+
+	inline StreamHasher::StreamHasher(const UInt64 seed) {
+		// A state that isn't heap-allocated must be initialized before a seeded reset
+		XXH3_INITSTATE(&m_State);
+		XXH3_128bits_reset_withSeed(&m_State, seed);
+	}
+
+	inline void StreamHasher::Update(const void* data, const USize size) {
+		XXH3_128bits_update(&m_State, data, size);
+	}
+
+	inline void StreamHasher::Update(const std::string_view str) {
+		UpdateValue(static_cast<UInt64>(str.size()));
+		Update(str.data(), str.size());
+	}
+
+	template <typename T>
+	void StreamHasher::Update(std::span<T> values) {
+		static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+		Update(values.data(), values.size_bytes());
+	}
+
+	template <typename T>
+	void StreamHasher::UpdateValue(const T& value) {
+		static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+		Update(&value, sizeof(T));
+	}
+
+	inline Hash128 StreamHasher::Digest() const {
+		const XXH128_hash_t hash = XXH3_128bits_digest(&m_State);
+		return {hash.low64, hash.high64};
+	}
+
+	inline Hash128 ComputeHash128(const void* data, const USize size, const UInt64 seed) {
+		const XXH128_hash_t hash = XXH3_128bits_withSeed(data, size, seed);
+		return {hash.low64, hash.high64};
+	}
+
+	inline Hash128 ComputeHash128(const std::string_view str, const UInt64 seed) {
+		return ComputeHash128(str.data(), str.size(), seed);
+	}
+
+	template <typename T>
+	Hash128 ComputeHash128(std::span<T> values, const UInt64 seed) {
+		static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+		return ComputeHash128(values.data(), values.size_bytes(), seed);
+	}
+
+	inline UInt64 StableHash(const void* data, const USize size, const UInt64 seed) {
+		return XXH3_64bits_withSeed(data, size, seed);
+	}
+
+	inline UInt64 StableHash(const std::string_view str, const UInt64 seed) {
+		return StableHash(str.data(), str.size(), seed);
+	}
 }
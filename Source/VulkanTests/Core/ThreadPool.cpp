@@ -0,0 +1,130 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#include <VulkanTests/Core/ThreadPool.hpp>
+
+namespace VkTests {
+	namespace {
+		// Identify the worker running on the current thread, if any.
+		thread_local const ThreadPool* g_CurrentPool = nullptr;
+		thread_local USize g_CurrentWorker = 0;
+	}
+
+	ThreadPool::ThreadPool(USize threadCount) {
+		threadCount = std::max<USize>(threadCount, 1);
+
+		m_Queues.reserve(threadCount);
+		for (USize i = 0; i < threadCount; ++i) {
+			m_Queues.push_back(std::make_unique<WorkerQueue>());
+		}
+
+		m_Threads.reserve(threadCount);
+		for (USize i = 0; i < threadCount; ++i) {
+			m_Threads.emplace_back([this, i] {
+				WorkerLoop(i);
+			});
+		}
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard lock{m_WakeMutex};
+			m_Stopping = true;
+		}
+
+		m_WakeCondition.notify_all();
+
+		for (auto& thread : m_Threads) {
+			thread.join();
+		}
+	}
+
+	void ThreadPool::Push(std::function<void()> task) {
+		const USize queueIndex = g_CurrentPool == this
+			                         ? g_CurrentWorker
+			                         : m_NextQueue.fetch_add(1, std::memory_order_relaxed) % m_Queues.size();
+
+		{
+			auto& queue = *m_Queues[queueIndex];
+			std::lock_guard lock{queue.Mutex};
+			queue.Tasks.push_back(std::move(task));
+		}
+
+		// Counted once queued, a worker claiming it always finds it in one of the queues.
+		{
+			std::lock_guard lock{m_WakeMutex};
+			++m_PendingTasks;
+		}
+
+		m_WakeCondition.notify_one();
+	}
+
+	bool ThreadPool::IsWorkerThread() const {
+		return g_CurrentPool == this;
+	}
+
+	bool ThreadPool::TryPop(const USize workerIndex, std::function<void()>& task) {
+		auto& queue = *m_Queues[workerIndex];
+		std::lock_guard lock{queue.Mutex};
+
+		if (queue.Tasks.empty()) {
+			return false;
+		}
+
+		// Newest first, its data is most likely still in the cache.
+		task = std::move(queue.Tasks.back());
+		queue.Tasks.pop_back();
+
+		return true;
+	}
+
+	bool ThreadPool::TrySteal(const USize workerIndex, std::function<void()>& task) {
+		for (USize i = 1; i < m_Queues.size(); ++i) {
+			auto& queue = *m_Queues[(workerIndex + i) % m_Queues.size()];
+			std::lock_guard lock{queue.Mutex};
+
+			if (queue.Tasks.empty()) {
+				continue;
+			}
+
+			// Steal the oldest task, away from where the owner is working.
+			task = std::move(queue.Tasks.front());
+			queue.Tasks.pop_front();
+
+			return true;
+		}
+
+		return false;
+	}
+
+	void ThreadPool::WorkerLoop(const USize workerIndex) {
+		g_CurrentPool = this;
+		g_CurrentWorker = workerIndex;
+
+		while (true) {
+			{
+				std::unique_lock lock{m_WakeMutex};
+				m_WakeCondition.wait(lock, [this] {
+					return m_Stopping || m_PendingTasks > 0;
+				});
+
+				if (m_PendingTasks == 0) {
+					return;
+				}
+
+				// Claims one of the queued tasks, the queues themselves are only guarded by their own lock.
+				--m_PendingTasks;
+			}
+
+			// Another worker may take the task seen here before this one locks its queue, but there are at least
+			// as many queued tasks as claims, the scan is retried until one is found.
+			std::function<void()> task;
+			while (!TryPop(workerIndex, task) && !TrySteal(workerIndex, task)) {
+				std::this_thread::yield();
+			}
+
+			task();
+		}
+	}
+}
@@ -0,0 +1,446 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#include <VulkanTests/Filesystem/AsyncFilesystem.hpp>
+#include <VulkanTests/Filesystem/StdFilesystem.hpp>
+
+#include <VulkanTests/Core/Logger.hpp>
+#include <VulkanTests/Core/ThreadPool.hpp>
+
+#ifdef VK_TESTS_IO_URING
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <liburing.h>
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <thread>
+#endif
+
+namespace VkTests::Filesystem {
+	class AsyncFilesystem::Engine {
+	public:
+		Engine() = default;
+		virtual ~Engine() = default;
+
+		Engine(const Engine&) = delete;
+		Engine(Engine&&) = delete;
+
+		Engine& operator=(const Engine&) = delete;
+		Engine& operator=(Engine&&) = delete;
+
+		virtual void Read(const std::vector<ReadRequest>& requests, BatchReadCallback callback) = 0;
+
+		virtual void Write(const Path& path, std::vector<UInt8> data, WriteCallback callback) = 0;
+	};
+
+	// Runs the operations through the decorated filesystem, one blocking call per worker at a time
+	class AsyncFilesystem::ThreadPoolEngine final : public Engine {
+	public:
+		ThreadPoolEngine(Filesystem& filesystem, const USize threadCount)
+			: m_Filesystem(filesystem), m_ThreadPool(threadCount) {
+		}
+
+		void Read(const std::vector<ReadRequest>& requests, BatchReadCallback callback) override {
+			auto sharedCallback = std::make_shared<BatchReadCallback>(std::move(callback));
+
+			for (USize i = 0; i < requests.size(); ++i) {
+				(void)m_ThreadPool.Submit([this, request = requests[i], i, sharedCallback] {
+					(*sharedCallback)(i, ReadRange(request));
+				});
+			}
+		}
+
+		void Write(const Path& path, std::vector<UInt8> data, WriteCallback callback) override {
+			(void)m_ThreadPool.Submit([this, path, data = std::move(data), callback = std::move(callback)] {
+				m_Filesystem.WriteFile(path, data);
+
+				// WriteFile doesn't report failures, the size of the file tells whether everything was written
+				const FileStat stat = m_Filesystem.StatFile(path);
+				callback(stat.IsFile && stat.Size == data.size());
+			});
+		}
+
+	private:
+		ReadResult ReadRange(const ReadRequest& request) {
+			ReadResult result{};
+
+			USize count = request.Count;
+			if (count == WholeFile) {
+				const FileStat stat = m_Filesystem.StatFile(request.File);
+				if (!stat.IsFile || request.Offset > stat.Size) {
+					return result;
+				}
+
+				count = stat.Size - request.Offset;
+			}
+
+			result.Data = m_Filesystem.ReadChunk(request.File, request.Offset, count);
+			result.Success = result.Data.size() == count;
+
+			return result;
+		}
+
+		Filesystem& m_Filesystem;
+
+		// Declared last, so that the pending tasks complete before the rest is destroyed
+		ThreadPool m_ThreadPool;
+	};
+
+#ifdef VK_TESTS_IO_URING
+	// Submits the operations to an io_uring, a dedicated thread reaps their completions. Short transfers are
+	// resubmitted until the whole range is transferred. At most QueueDepth operations are in flight, so the
+	// submission queue can't fill up nor the completion queue overflow; the others wait in a backlog.
+	class AsyncFilesystem::UringEngine final : public Engine {
+	public:
+		static std::unique_ptr<UringEngine> Create() {
+			auto engine = std::unique_ptr<UringEngine>(new UringEngine);
+
+			// Kernels without io_uring, or sandboxes forbidding it, fall back to the thread pool
+			if (const int result = io_uring_queue_init(QueueDepth, &engine->m_Ring, 0); result < 0) {
+				Log::Warn("io_uring is unavailable ({}), file I/O runs on a thread pool.", std::strerror(-result));
+				return nullptr;
+			}
+
+			engine->m_Initialized = true;
+			engine->m_CompletionThread = std::thread([engine = engine.get()] {
+				engine->CompletionLoop();
+			});
+
+			return engine;
+		}
+
+		~UringEngine() override {
+			if (!m_Initialized) {
+				return;
+			}
+
+			// A NOP without operation tells the completion thread to stop, once everything else completed
+			{
+				std::unique_lock lock{m_Mutex};
+				m_IdleCondition.wait(lock, [this] { return m_InFlightCount == 0 && m_Backlog.empty(); });
+
+				io_uring_sqe* sqe = io_uring_get_sqe(&m_Ring);
+				io_uring_prep_nop(sqe);
+				io_uring_sqe_set_data(sqe, nullptr);
+				io_uring_submit(&m_Ring);
+			}
+
+			m_CompletionThread.join();
+
+			io_uring_queue_exit(&m_Ring);
+		}
+
+		void Read(const std::vector<ReadRequest>& requests, BatchReadCallback callback) override {
+			auto sharedCallback = std::make_shared<BatchReadCallback>(std::move(callback));
+
+			std::vector<std::unique_ptr<Operation>> operations;
+			operations.reserve(requests.size());
+
+			for (USize i = 0; i < requests.size(); ++i) {
+				const auto& request = requests[i];
+
+				auto complete = [sharedCallback, i](const bool success, std::vector<UInt8>&& data) {
+					ReadResult result{};
+					result.Success = success;
+					if (success) {
+						result.Data = std::move(data);
+					}
+
+					(*sharedCallback)(i, std::move(result));
+				};
+
+				const int fd = open(request.File.c_str(), O_RDONLY | O_CLOEXEC);
+				if (fd < 0) {
+					Log::Error("Failed to open file at path: {0}; Error: {1}", request.File.string(),
+					           std::strerror(errno));
+					complete(false, {});
+					continue;
+				}
+
+				USize count = request.Count;
+				if (count == WholeFile) {
+					struct stat fdStat{};
+					if (fstat(fd, &fdStat) != 0 || request.Offset > static_cast<USize>(fdStat.st_size)) {
+						close(fd);
+						complete(false, {});
+						continue;
+					}
+
+					count = static_cast<USize>(fdStat.st_size) - request.Offset;
+				}
+
+				if (count == 0) {
+					close(fd);
+					complete(true, {});
+					continue;
+				}
+
+				auto operation = std::make_unique<Operation>();
+				operation->Fd = fd;
+				operation->Offset = request.Offset;
+				operation->Buffer.resize(count);
+				operation->Complete = std::move(complete);
+
+				operations.push_back(std::move(operation));
+			}
+
+			Submit(operations);
+		}
+
+		void Write(const Path& path, std::vector<UInt8> data, WriteCallback callback) override {
+			std::error_code ec;
+			std::filesystem::create_directories(path.parent_path(), ec);
+
+			const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+			if (fd < 0) {
+				Log::Error("Failed to open file at path: {0}; Error: {1}", path.string(), std::strerror(errno));
+				callback(false);
+				return;
+			}
+
+			if (data.empty()) {
+				close(fd);
+				callback(true);
+				return;
+			}
+
+			auto operation = std::make_unique<Operation>();
+			operation->Fd = fd;
+			operation->IsWrite = true;
+			operation->Buffer = std::move(data);
+			operation->Complete = [callback = std::move(callback)](const bool success, std::vector<UInt8>&&) {
+				callback(success);
+			};
+
+			std::vector<std::unique_ptr<Operation>> operations;
+			operations.push_back(std::move(operation));
+
+			Submit(operations);
+		}
+
+	private:
+		static constexpr unsigned QueueDepth = 256;
+
+		// The length of a single read or write is limited, larger transfers are split
+		static constexpr USize MaxTransferSize = 1u << 30;
+
+		struct Operation {
+			int Fd = -1;
+			bool IsWrite = false;
+
+			// The file offset of the beginning of the buffer, and how much of the buffer is already transferred
+			USize Offset = 0;
+			USize Transferred = 0;
+
+			std::vector<UInt8> Buffer;
+
+			std::function<void(bool success, std::vector<UInt8>&& data)> Complete;
+		};
+
+		UringEngine() = default;
+
+		// Must be called with the mutex locked, there is always a free entry for an operation in flight
+		void Prepare(Operation& operation) {
+			io_uring_sqe* sqe = io_uring_get_sqe(&m_Ring);
+
+			UInt8* buffer = operation.Buffer.data() + operation.Transferred;
+			const auto length = static_cast<unsigned>(std::min(operation.Buffer.size() - operation.Transferred,
+			                                                   MaxTransferSize));
+			const auto offset = static_cast<UInt64>(operation.Offset + operation.Transferred);
+
+			if (operation.IsWrite) {
+				io_uring_prep_write(sqe, operation.Fd, buffer, length, offset);
+			} else {
+				io_uring_prep_read(sqe, operation.Fd, buffer, length, offset);
+			}
+
+			io_uring_sqe_set_data(sqe, &operation);
+		}
+
+		void Submit(std::vector<std::unique_ptr<Operation>>& operations) {
+			if (operations.empty()) {
+				return;
+			}
+
+			// The whole batch goes to the kernel with a single system call
+			std::lock_guard lock{m_Mutex};
+			for (auto& operation : operations) {
+				if (m_InFlightCount < QueueDepth) {
+					++m_InFlightCount;
+					Prepare(*operation.release());
+				} else {
+					m_Backlog.push_back(std::move(operation));
+				}
+			}
+
+			io_uring_submit(&m_Ring);
+		}
+
+		void Resubmit(Operation& operation) {
+			std::lock_guard lock{m_Mutex};
+			Prepare(operation);
+			io_uring_submit(&m_Ring);
+		}
+
+		void Finish(Operation* operation, const bool success) {
+			{
+				const std::unique_ptr<Operation> owner{operation};
+
+				// Called without the mutex held, callbacks may submit new operations
+				close(operation->Fd);
+				operation->Complete(success, std::move(operation->Buffer));
+			}
+
+			std::lock_guard lock{m_Mutex};
+
+			// The slot of the finished operation goes to the oldest one waiting
+			if (!m_Backlog.empty()) {
+				Prepare(*m_Backlog.front().release());
+				m_Backlog.pop_front();
+				io_uring_submit(&m_Ring);
+				return;
+			}
+
+			if (--m_InFlightCount == 0) {
+				m_IdleCondition.notify_all();
+			}
+		}
+
+		void CompletionLoop() {
+			while (true) {
+				io_uring_cqe* cqe;
+				if (const int result = io_uring_wait_cqe(&m_Ring, &cqe); result < 0) {
+					if (result == -EINTR) {
+						continue;
+					}
+
+					Log::Error("Failed to wait for io_uring completions: {}", std::strerror(-result));
+					return;
+				}
+
+				auto* operation = static_cast<Operation*>(io_uring_cqe_get_data(cqe));
+				const int result = cqe->res;
+				io_uring_cqe_seen(&m_Ring, cqe);
+
+				if (!operation) {
+					return;
+				}
+
+				if (result == -EINTR || result == -EAGAIN) {
+					Resubmit(*operation);
+					continue;
+				}
+
+				// Reaching the end of the file before the end of the range is a failure too
+				if (result <= 0) {
+					if (result < 0) {
+						Log::Error("Asynchronous file {} failed: {}", operation->IsWrite ? "write" : "read",
+						           std::strerror(-result));
+					}
+
+					Finish(operation, false);
+					continue;
+				}
+
+				operation->Transferred += static_cast<USize>(result);
+
+				if (operation->Transferred < operation->Buffer.size()) {
+					Resubmit(*operation);
+					continue;
+				}
+
+				Finish(operation, true);
+			}
+		}
+
+		io_uring m_Ring{};
+		bool m_Initialized{false};
+
+		// Guards the submission queue, the number of operations in flight and the backlog
+		std::mutex m_Mutex;
+		std::condition_variable m_IdleCondition;
+		USize m_InFlightCount{0};
+		std::deque<std::unique_ptr<Operation>> m_Backlog;
+
+		std::thread m_CompletionThread;
+	};
+#endif
+
+	AsyncFilesystem::AsyncFilesystem(FilesystemPtr filesystem, const USize threadCount)
+		: m_Filesystem(std::move(filesystem)) {
+#ifdef VK_TESTS_IO_URING
+		// io_uring works on the real paths, other filesystems are only reachable through their interface
+		if (std::dynamic_pointer_cast<StdFilesystem>(m_Filesystem)) {
+			m_Engine = UringEngine::Create();
+			m_UsesIoUring = m_Engine != nullptr;
+		}
+#endif
+
+		if (!m_Engine) {
+			m_Engine = std::make_unique<ThreadPoolEngine>(*m_Filesystem, threadCount);
+		}
+	}
+
+	AsyncFilesystem::~AsyncFilesystem() = default;
+
+	std::future<AsyncFilesystem::ReadResult> AsyncFilesystem::ReadAsync(const Path& path, const USize offset,
+	                                                                     const USize count) {
+		auto promise = std::make_shared<std::promise<ReadResult>>();
+		auto future = promise->get_future();
+
+		ReadAsync(path, offset, count, [promise](ReadResult&& result) {
+			promise->set_value(std::move(result));
+		});
+
+		return future;
+	}
+
+	void AsyncFilesystem::ReadAsync(const Path& path, const USize offset, const USize count,
+	                                ReadCallback callback) {
+		m_Engine->Read({{path, offset, count}}, [callback = std::move(callback)](USize, ReadResult&& result) {
+			callback(std::move(result));
+		});
+	}
+
+	std::vector<std::future<AsyncFilesystem::ReadResult>> AsyncFilesystem::ReadBatchAsync(
+		const std::vector<ReadRequest>& requests) {
+		auto promises = std::make_shared<std::vector<std::promise<ReadResult>>>(requests.size());
+
+		std::vector<std::future<ReadResult>> futures;
+		futures.reserve(requests.size());
+		for (auto& promise : *promises) {
+			futures.push_back(promise.get_future());
+		}
+
+		ReadBatchAsync(requests, [promises](const USize requestIndex, ReadResult&& result) {
+			(*promises)[requestIndex].set_value(std::move(result));
+		});
+
+		return futures;
+	}
+
+	void AsyncFilesystem::ReadBatchAsync(const std::vector<ReadRequest>& requests, BatchReadCallback callback) {
+		m_Engine->Read(requests, std::move(callback));
+	}
+
+	std::future<bool> AsyncFilesystem::WriteAsync(const Path& path, std::vector<UInt8> data) {
+		auto promise = std::make_shared<std::promise<bool>>();
+		auto future = promise->get_future();
+
+		WriteAsync(path, std::move(data), [promise](const bool success) {
+			promise->set_value(success);
+		});
+
+		return future;
+	}
+
+	void AsyncFilesystem::WriteAsync(const Path& path, std::vector<UInt8> data, WriteCallback callback) {
+		m_Engine->Write(path, std::move(data), std::move(callback));
+	}
+}
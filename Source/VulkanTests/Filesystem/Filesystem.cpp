@@ -10,6 +10,17 @@ namespace VkTests::Filesystem {
 		FilesystemPtr g_filesystem = nullptr;
 	}
 
+	std::string NormalizePath(const Path& path) {
+		const Path absolute = path.is_absolute() ? path : std::filesystem::absolute(path);
+
+		std::string normalized = absolute.lexically_normal().generic_string();
+		while (normalized.size() > 1 && normalized.back() == '/') {
+			normalized.pop_back();
+		}
+
+		return normalized;
+	}
+
 	void Initialize() {
 		g_filesystem = std::make_shared<StdFilesystem>();
 	}
@@ -22,4 +33,9 @@ namespace VkTests::Filesystem {
 		assert(g_filesystem && "Filesystem not initialized.");
 		return g_filesystem;
 	}
+
+	void Set(FilesystemPtr filesystem) {
+		assert(filesystem && "Filesystem can't be null.");
+		g_filesystem = std::move(filesystem);
+	}
 }
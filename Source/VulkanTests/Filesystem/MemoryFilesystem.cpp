@@ -0,0 +1,184 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#include <VulkanTests/Filesystem/MemoryFilesystem.hpp>
+
+#include <VulkanTests/Core/Logger.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+namespace VkTests::Filesystem {
+	MemoryFilesystem::MemoryFilesystem(Path externalStorageDirectory, Path tempDirectory)
+		: m_ExternalStorageDirectory(std::move(externalStorageDirectory)), m_TempDirectory(std::move(tempDirectory)) {
+	}
+
+	FileStat MemoryFilesystem::StatFile(const Path& path) {
+		const std::string normalizedPath = NormalizePath(path);
+
+		std::shared_lock lock{m_Mutex};
+
+		if (const auto it = m_Files.find(normalizedPath); it != m_Files.end()) {
+			return FileStat{true, false, it->second.Data.size()};
+		}
+
+		if (m_Directories.contains(normalizedPath)) {
+			return FileStat{false, true, 0};
+		}
+
+		return FileStat{false, false, 0};
+	}
+
+	bool MemoryFilesystem::CreateDirectory(const Path& path) {
+		const std::string normalizedPath = NormalizePath(path);
+
+		std::unique_lock lock{m_Mutex};
+
+		if (m_Files.contains(normalizedPath)) {
+			Log::Error("Failed to create directory at path: {0}: Error: A file has the same path", path.string());
+			return false;
+		}
+
+		AddDirectories(normalizedPath);
+
+		return true;
+	}
+
+	std::vector<UInt8> MemoryFilesystem::ReadChunk(const Path& path, const USize offset, const USize count) {
+		const std::string normalizedPath = NormalizePath(path);
+
+		std::shared_lock lock{m_Mutex};
+
+		const auto it = m_Files.find(normalizedPath);
+		if (it == m_Files.end()) {
+			Log::Error("Failed to open file at path: {0}", path.string());
+			return {};
+		}
+
+		const auto data = it->second.Data;
+		if (offset > data.size() || count > data.size() - offset) {
+			return {};
+		}
+
+		return {data.begin() + static_cast<std::ptrdiff_t>(offset),
+		        data.begin() + static_cast<std::ptrdiff_t>(offset + count)};
+	}
+
+	void MemoryFilesystem::WriteFile(const Path& path, const std::vector<UInt8>& data) {
+		WriteFile(path, std::span<const UInt8>{data});
+	}
+
+	void MemoryFilesystem::WriteFile(const Path& path, const std::span<const UInt8> data) {
+		std::string normalizedPath = NormalizePath(path);
+
+		// The copy is made outside the lock, a large file doesn't stall the other accesses
+		File file = Allocate(data);
+
+		std::unique_lock lock{m_Mutex};
+
+		if (m_Directories.contains(normalizedPath)) {
+			Log::Error("Failed to open file at path: {}", path.string());
+			return;
+		}
+
+		if (const USize separator = normalizedPath.rfind('/'); separator != std::string::npos) {
+			AddDirectories(std::string_view{normalizedPath}.substr(0, std::max<USize>(separator, 1)));
+		}
+
+		m_StorageSize += data.size();
+
+		// The previous contents are released with their last mapping
+		if (const auto [it, inserted] = m_Files.try_emplace(std::move(normalizedPath), std::move(file)); !inserted) {
+			m_StorageSize -= it->second.Data.size();
+			it->second = std::move(file);
+		}
+	}
+
+	void MemoryFilesystem::Remove(const Path& path) {
+		const std::string normalizedPath = NormalizePath(path);
+
+		std::unique_lock lock{m_Mutex};
+
+		if (const auto it = m_Files.find(normalizedPath); it != m_Files.end()) {
+			m_StorageSize -= it->second.Data.size();
+			m_Files.erase(it);
+			return;
+		}
+
+		if (!m_Directories.contains(normalizedPath)) {
+			Log::Error("Failed to remove path: {0}; Error: No such file or directory", path.string());
+			return;
+		}
+
+		// Like std::filesystem::remove, only empty directories are removed
+		const std::string prefix = normalizedPath.ends_with('/') ? normalizedPath : normalizedPath + '/';
+		const auto isChild = [&prefix](const std::string& child) {
+			return child.starts_with(prefix);
+		};
+
+		if (std::ranges::any_of(m_Files, isChild, &decltype(m_Files)::value_type::first) ||
+			std::ranges::any_of(m_Directories, isChild)) {
+			Log::Error("Failed to remove path: {0}; Error: Directory not empty", path.string());
+			return;
+		}
+
+		m_Directories.erase(normalizedPath);
+	}
+
+	MappedFile MemoryFilesystem::MapFile(const Path& path) {
+		const std::string normalizedPath = NormalizePath(path);
+
+		std::shared_lock lock{m_Mutex};
+
+		const auto it = m_Files.find(normalizedPath);
+		if (it == m_Files.end()) {
+			return {};
+		}
+
+		return {it->second.Data, it->second.Storage};
+	}
+
+	void MemoryFilesystem::Clear() {
+		std::unique_lock lock{m_Mutex};
+
+		m_Files.clear();
+		m_Directories.clear();
+		m_StorageSize = 0;
+	}
+
+	USize MemoryFilesystem::GetFileCount() const {
+		std::shared_lock lock{m_Mutex};
+		return m_Files.size();
+	}
+
+	USize MemoryFilesystem::GetStorageSize() const {
+		std::shared_lock lock{m_Mutex};
+		return m_StorageSize;
+	}
+
+	MemoryFilesystem::File MemoryFilesystem::Allocate(const std::span<const UInt8> data) {
+		// The contents and the control block share one allocation
+		std::shared_ptr<UInt8[]> storage = std::make_shared_for_overwrite<UInt8[]>(data.size());
+
+		if (!data.empty()) {
+			std::memcpy(storage.get(), data.data(), data.size());
+		}
+
+		return {std::span<const UInt8>{storage.get(), data.size()}, std::move(storage)};
+	}
+
+	void MemoryFilesystem::AddDirectories(std::string_view normalizedDirectory) {
+		// Stops at the first directory already present, its parents are then present too
+		while (m_Directories.emplace(normalizedDirectory).second) {
+			const USize separator = normalizedDirectory.rfind('/');
+			if (separator == std::string_view::npos || normalizedDirectory.size() == 1) {
+				break;
+			}
+
+			// The root keeps its slash
+			normalizedDirectory = normalizedDirectory.substr(0, std::max<USize>(separator, 1));
+		}
+	}
+}
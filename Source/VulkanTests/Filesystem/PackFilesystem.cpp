@@ -0,0 +1,355 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#include <VulkanTests/Filesystem/PackFilesystem.hpp>
+
+#include <VulkanTests/Core/Logger.hpp>
+
+#include <VulkanTests/Utils/Hash.hpp>
+
+#ifdef VK_TESTS_LZ4
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <tuple>
+
+namespace VkTests::Filesystem {
+	namespace {
+		USize AlignUp(const USize value, const USize alignment) {
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+
+		// The storage and temporary directories of an archive alone
+		const Path g_EmptyPath;
+	}
+
+	PackFilesystem::PackFilesystem(FilesystemPtr filesystem, const Path& mountPoint)
+		: m_Filesystem(std::move(filesystem)), m_MountPoint(NormalizePath(mountPoint)) {
+	}
+
+	bool PackFilesystem::Open(const Path& path) {
+		m_Data = (m_Filesystem ? m_Filesystem : Get())->MapFile(path);
+		m_Names = {};
+		m_Index.clear();
+		m_Directories.clear();
+
+		if (!m_Data.IsValid()) {
+			Log::Error("Pack archive \"{}\" doesn't exist.", path.string());
+			return false;
+		}
+
+		const auto data = m_Data.GetData();
+
+		Header header{};
+		if (data.size() < sizeof(Header)) {
+			Log::Error("Pack archive \"{}\" is truncated.", path.string());
+			return false;
+		}
+
+		std::memcpy(&header, data.data(), sizeof(Header));
+
+		if (header.Magic != Magic || header.Version != Version) {
+			Log::Error("\"{}\" isn't a pack archive, or was packed by another version.", path.string());
+			return false;
+		}
+
+		if (header.EntryCount > (data.size() - sizeof(Header)) / sizeof(Entry) ||
+			header.NamesOffset != sizeof(Header) + header.EntryCount * sizeof(Entry)) {
+			Log::Error("Pack archive \"{}\" has an invalid index.", path.string());
+			return false;
+		}
+
+		m_Names = m_Data.GetView(header.NamesOffset, header.NamesSize);
+		if (!m_Names.IsValid()) {
+			Log::Error("Pack archive \"{}\" has an invalid index.", path.string());
+			return false;
+		}
+
+		m_Index.resize(header.EntryCount);
+		std::memcpy(m_Index.data(), data.data() + sizeof(Header), header.EntryCount * sizeof(Entry));
+
+		for (const auto& entry : m_Index) {
+			// LZ4 handles sizes up to 2 GB
+			const bool compressionValid = entry.Compression == PackCompression::None
+				                              ? entry.Size == entry.OriginalSize
+				                              : entry.Compression == PackCompression::LZ4 &&
+				                              entry.OriginalSize <= std::numeric_limits<Int32>::max();
+
+			if (!m_Data.GetView(entry.Offset, entry.Size).IsValid() ||
+				UInt64{entry.NameOffset} + entry.NameSize > header.NamesSize || !compressionValid) {
+				Log::Error("Pack archive \"{}\" has an entry out of bounds.", path.string());
+				m_Index.clear();
+				return false;
+			}
+
+			if (!IsCompressionSupported(entry.Compression)) {
+				Log::Error("Pack archive \"{}\" holds compressed files, which this build can't read.", path.string());
+				m_Index.clear();
+				return false;
+			}
+
+			// Every parent directory of the file exists in the archive, the mount point included
+			const std::string_view name = GetName(entry);
+			for (USize separator = name.find('/'); separator != std::string_view::npos;
+			     separator = name.find('/', separator + 1)) {
+				m_Directories.emplace(name.substr(0, separator));
+			}
+		}
+
+		m_Directories.emplace();
+
+		return true;
+	}
+
+	FileStat PackFilesystem::StatFile(const Path& path) {
+		if (const auto relativePath = GetRelativePath(path)) {
+			if (const auto* entry = FindEntry(*relativePath)) {
+				return FileStat{true, false, entry->OriginalSize};
+			}
+
+			if (m_Directories.contains(*relativePath)) {
+				return FileStat{false, true, 0};
+			}
+		}
+
+		return m_Filesystem ? m_Filesystem->StatFile(path) : FileStat{false, false, 0};
+	}
+
+	std::vector<UInt8> PackFilesystem::ReadChunk(const Path& path, const USize offset, const USize count) {
+		const auto relativePath = GetRelativePath(path);
+		const auto* entry = relativePath ? FindEntry(*relativePath) : nullptr;
+
+		if (!entry) {
+			return m_Filesystem ? m_Filesystem->ReadChunk(path, offset, count) : std::vector<UInt8>{};
+		}
+
+		// A compressed file is decompressed entirely, even to read a part of it
+		const auto chunk = ReadEntry(*entry).GetView(offset, count);
+		if (!chunk.IsValid()) {
+			return {};
+		}
+
+		return {chunk.GetData().begin(), chunk.GetData().end()};
+	}
+
+	MappedFile PackFilesystem::MapFile(const Path& path) {
+		const auto relativePath = GetRelativePath(path);
+		const auto* entry = relativePath ? FindEntry(*relativePath) : nullptr;
+
+		if (!entry) {
+			return m_Filesystem ? m_Filesystem->MapFile(path) : MappedFile{};
+		}
+
+		return ReadEntry(*entry);
+	}
+
+	void PackFilesystem::WriteFile(const Path& path, const std::vector<UInt8>& data) {
+		if (!m_Filesystem) {
+			Log::Error("Can't write \"{}\", pack archives are read-only.", path.string());
+			return;
+		}
+
+		m_Filesystem->WriteFile(path, data);
+	}
+
+	void PackFilesystem::Remove(const Path& path) {
+		if (!m_Filesystem) {
+			Log::Error("Can't remove \"{}\", pack archives are read-only.", path.string());
+			return;
+		}
+
+		m_Filesystem->Remove(path);
+	}
+
+	const Path& PackFilesystem::ExternalStorageDirectory() const {
+		return m_Filesystem ? m_Filesystem->ExternalStorageDirectory() : g_EmptyPath;
+	}
+
+	const Path& PackFilesystem::TempDirectory() const {
+		return m_Filesystem ? m_Filesystem->TempDirectory() : g_EmptyPath;
+	}
+
+	bool PackFilesystem::IsCompressionSupported(const PackCompression compression) {
+		switch (compression) {
+		case PackCompression::None:
+			return true;
+		case PackCompression::LZ4:
+#ifdef VK_TESTS_LZ4
+			return true;
+#else
+			return false;
+#endif
+		default:
+			return false;
+		}
+	}
+
+	bool PackFilesystem::CompareEntries(const Entry& lhs, const UInt64 pathHash) {
+		return lhs.PathHash < pathHash;
+	}
+
+	std::optional<std::string> PackFilesystem::GetRelativePath(const Path& path) const {
+		if (m_Index.empty()) {
+			return std::nullopt;
+		}
+
+		const std::string normalized = NormalizePath(path);
+		if (!normalized.starts_with(m_MountPoint)) {
+			return std::nullopt;
+		}
+
+		USize start = m_MountPoint.size();
+
+		// Only the root keeps its trailing slash
+		if (m_MountPoint.back() != '/') {
+			if (normalized.size() == start) {
+				return std::string{};
+			}
+
+			if (normalized[start] != '/') {
+				return std::nullopt;
+			}
+
+			++start;
+		}
+
+		return normalized.substr(start);
+	}
+
+	const PackFilesystem::Entry* PackFilesystem::FindEntry(const std::string_view relativePath) const {
+		const UInt64 pathHash = StableHash(relativePath);
+
+		// Entries with the same hash are adjacent, their names tell them apart
+		for (auto it = std::lower_bound(m_Index.begin(), m_Index.end(), pathHash, CompareEntries);
+		     it != m_Index.end() && it->PathHash == pathHash; ++it) {
+			if (GetName(*it) == relativePath) {
+				return &*it;
+			}
+		}
+
+		return nullptr;
+	}
+
+	std::string_view PackFilesystem::GetName(const Entry& entry) const {
+		return m_Names.GetString().substr(entry.NameOffset, entry.NameSize);
+	}
+
+	MappedFile PackFilesystem::ReadEntry(const Entry& entry) const {
+		const auto contents = m_Data.GetView(entry.Offset, entry.Size);
+
+		if (entry.Compression == PackCompression::None) {
+			return contents;
+		}
+
+#ifdef VK_TESTS_LZ4
+		if (entry.Compression == PackCompression::LZ4) {
+			std::vector<UInt8> data(entry.OriginalSize);
+
+			const int size = LZ4_decompress_safe(reinterpret_cast<const char*>(contents.GetData().data()),
+			                                     reinterpret_cast<char*>(data.data()), static_cast<int>(entry.Size),
+			                                     static_cast<int>(entry.OriginalSize));
+
+			if (size < 0 || static_cast<USize>(size) != entry.OriginalSize) {
+				Log::Error("Corrupted pack archive entry \"{}\".", GetName(entry));
+				return {};
+			}
+
+			return MappedFile{std::move(data)};
+		}
+#endif
+
+		Log::Error("Pack archive entry \"{}\" is compressed with an unsupported method.", GetName(entry));
+		return {};
+	}
+
+	void PackWriter::Add(const std::string& name, std::vector<UInt8> data, const PackCompression compression) {
+		const USize originalSize = data.size();
+
+#ifdef VK_TESTS_LZ4
+		if (compression == PackCompression::LZ4 && !data.empty() && data.size() <= LZ4_MAX_INPUT_SIZE) {
+			std::vector<UInt8> compressed(LZ4_compressBound(static_cast<int>(data.size())));
+
+			// Packing is done offline, the slower high compression mode costs nothing at runtime
+			const int size = LZ4_compress_HC(reinterpret_cast<const char*>(data.data()),
+			                                 reinterpret_cast<char*>(compressed.data()), static_cast<int>(data.size()),
+			                                 static_cast<int>(compressed.size()), LZ4HC_CLEVEL_DEFAULT);
+
+			if (size > 0 && static_cast<USize>(size) < data.size()) {
+				compressed.resize(static_cast<USize>(size));
+				m_Entries.push_back({name, std::move(compressed), originalSize, PackCompression::LZ4});
+				return;
+			}
+		}
+#else
+		(void)compression;
+#endif
+
+		m_Entries.push_back({name, std::move(data), originalSize, PackCompression::None});
+	}
+
+	void PackWriter::Write(const Path& path) const {
+		// The index is sorted by path hash, so that the runtime can binary search it
+		std::vector<std::pair<UInt64, const PendingEntry*>> entries;
+		entries.reserve(m_Entries.size());
+
+		for (const auto& entry : m_Entries) {
+			entries.emplace_back(StableHash(entry.Name), &entry);
+		}
+
+		std::ranges::stable_sort(entries, [](const auto& lhs, const auto& rhs) {
+			return std::tie(lhs.first, lhs.second->Name) < std::tie(rhs.first, rhs.second->Name);
+		});
+
+		const auto duplicates = std::ranges::unique(entries, {}, [](const auto& entry) -> const std::string& {
+			return entry.second->Name;
+		});
+		entries.erase(duplicates.begin(), duplicates.end());
+
+		std::string names;
+		std::vector<PackFilesystem::Entry> index;
+		index.reserve(entries.size());
+
+		for (const auto& [pathHash, entry] : entries) {
+			PackFilesystem::Entry indexEntry{};
+			indexEntry.PathHash = pathHash;
+			indexEntry.OriginalSize = entry->OriginalSize;
+			indexEntry.Size = entry->Data.size();
+			indexEntry.NameOffset = static_cast<UInt32>(names.size());
+			indexEntry.NameSize = static_cast<UInt32>(entry->Name.size());
+			indexEntry.Compression = entry->Compression;
+
+			names += entry->Name;
+			index.push_back(indexEntry);
+		}
+
+		PackFilesystem::Header header{};
+		header.Magic = PackFilesystem::Magic;
+		header.Version = PackFilesystem::Version;
+		header.EntryCount = index.size();
+		header.NamesOffset = sizeof(PackFilesystem::Header) + index.size() * sizeof(PackFilesystem::Entry);
+		header.NamesSize = names.size();
+
+		// The contents follow the index, each aligned from the start of the file
+		std::vector<UInt8> data(header.NamesOffset + header.NamesSize);
+
+		for (USize i = 0; i < entries.size(); ++i) {
+			const auto& contents = entries[i].second->Data;
+
+			data.resize(AlignUp(data.size(), m_Alignment));
+			index[i].Offset = data.size();
+			data.insert(data.end(), contents.begin(), contents.end());
+		}
+
+		std::memcpy(data.data(), &header, sizeof(PackFilesystem::Header));
+		std::memcpy(data.data() + sizeof(PackFilesystem::Header), index.data(),
+		            index.size() * sizeof(PackFilesystem::Entry));
+		std::memcpy(data.data() + header.NamesOffset, names.data(), names.size());
+
+		Get()->WriteFile(path, data);
+	}
+}
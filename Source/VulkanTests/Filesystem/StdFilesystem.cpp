@@ -10,10 +10,26 @@
 #include <VulkanTests/Libs/AntiWindows.hpp>
 #endif
 
+#ifdef VK_TESTS_PLATFORM_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
 namespace VkTests::Filesystem {
 	FileStat StdFilesystem::StatFile(const Path& path) {
 		std::error_code ec;
 		const auto fsStat = std::filesystem::status(path, ec);
+
+		// A missing path is an answer, not an error, layered filesystems probe for paths all the time
+		if (fsStat.type() == std::filesystem::file_type::not_found) {
+			return FileStat{false, false, 0};
+		}
+
 		if (ec) {
 			Log::Error("Failed to retrieve status for path: {0}; Error: {1}", path.string(), ec.message());
 			return FileStat{false, false, 0};
@@ -48,9 +64,11 @@ namespace VkTests::Filesystem {
 
 		if (!file.is_open()) {
 			Log::Error("Failed to open file at path: {0}", path.string());
+			return {};
 		}
 
-		if (const auto size = StatFile(path).Size;
+		// Opened at the end, the position is the size of the file
+		if (const auto size = static_cast<USize>(file.tellg());
 			offset + count > size) {
 			return {};
 		}
@@ -80,6 +98,49 @@ namespace VkTests::Filesystem {
 		file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
 	}
 
+	MappedFile StdFilesystem::MapFile(const Path& path) {
+#ifdef VK_TESTS_PLATFORM_UNIX
+		const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0) {
+			Log::Error("Failed to open file at path: {0}; Error: {1}", path.string(), std::strerror(errno));
+			return {};
+		}
+
+		struct stat fdStat{};
+		if (fstat(fd, &fdStat) != 0 || !S_ISREG(fdStat.st_mode)) {
+			Log::Error("Failed to map file at path: {0}; It isn't a regular file", path.string());
+			close(fd);
+			return {};
+		}
+
+		const auto size = static_cast<USize>(fdStat.st_size);
+
+		// Empty files can't be mapped
+		if (size == 0) {
+			close(fd);
+			return MappedFile{std::vector<UInt8>{}};
+		}
+
+		void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		// The mapping keeps its own reference to the file
+		close(fd);
+
+		if (address == MAP_FAILED) {
+			Log::Error("Failed to map file at path: {0}; Error: {1}", path.string(), std::strerror(errno));
+			return {};
+		}
+
+		std::shared_ptr<const void> owner{address, [size](const void* mapping) {
+			munmap(const_cast<void*>(mapping), size);
+		}};
+
+		return {{static_cast<const UInt8*>(address), size}, std::move(owner)};
+#else
+		return Filesystem::MapFile(path);
+#endif
+	}
+
 	void StdFilesystem::Remove(const Path& path) {
 		std::error_code ec;
 
@@ -0,0 +1,242 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#include <VulkanTests/Filesystem/VirtualFilesystem.hpp>
+
+#include <VulkanTests/Core/Logger.hpp>
+
+#include <VulkanTests/Utils/Hash.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <tuple>
+
+namespace VkTests::Filesystem {
+	VirtualFilesystem::VirtualFilesystem(Path externalStorageDirectory, Path tempDirectory)
+		: m_ExternalStorageDirectory(std::move(externalStorageDirectory)), m_TempDirectory(std::move(tempDirectory)) {
+	}
+
+	void VirtualFilesystem::Mount(const Path& directory, FilesystemPtr filesystem, const Int32 priority,
+	                              const bool readOnly, const Path& root) {
+		assert(filesystem && "Can't mount a null filesystem.");
+
+		std::string normalizedDirectory = NormalizePath(directory);
+		const UInt64 directoryHash = StableHash(normalizedDirectory);
+
+		std::unique_lock lock{m_Mutex};
+
+		auto mount = std::make_shared<const MountPoint>(MountPoint{
+			std::move(normalizedDirectory), std::move(filesystem), root, priority, readOnly, m_NextOrder++
+		});
+
+		m_Mounts[directoryHash].push_back(std::move(mount));
+		++m_MountCount;
+
+		InvalidateCache();
+	}
+
+	bool VirtualFilesystem::Unmount(const Path& directory, const FilesystemPtr& filesystem) {
+		const std::string normalizedDirectory = NormalizePath(directory);
+
+		std::unique_lock lock{m_Mutex};
+
+		const auto it = m_Mounts.find(StableHash(normalizedDirectory));
+		if (it == m_Mounts.end()) {
+			return false;
+		}
+
+		const auto removed = std::erase_if(it->second, [&](const MountPointPtr& mount) {
+			return mount->Directory == normalizedDirectory && mount->Filesystem == filesystem;
+		});
+
+		if (it->second.empty()) {
+			m_Mounts.erase(it);
+		}
+
+		if (removed == 0) {
+			return false;
+		}
+
+		m_MountCount -= removed;
+
+		InvalidateCache();
+
+		return true;
+	}
+
+	void VirtualFilesystem::ClearCache() {
+		std::unique_lock lock{m_Mutex};
+		InvalidateCache();
+	}
+
+	FileStat VirtualFilesystem::StatFile(const Path& path) {
+		const auto resolved = Resolve(path);
+		if (!resolved) {
+			return FileStat{false, false, 0};
+		}
+
+		return resolved->Mount->Filesystem->StatFile(resolved->Target);
+	}
+
+	bool VirtualFilesystem::CreateDirectory(const Path& path) {
+		const auto resolved = ResolveWritable(path);
+		if (!resolved) {
+			Log::Error("Can't create directory \"{}\", it isn't in a writable mount.", path.string());
+			return false;
+		}
+
+		return resolved->Mount->Filesystem->CreateDirectory(resolved->Target);
+	}
+
+	std::vector<UInt8> VirtualFilesystem::ReadChunk(const Path& path, const USize offset, const USize count) {
+		const auto resolved = Resolve(path);
+		if (!resolved) {
+			Log::Error("Can't read \"{}\", it isn't in any mount.", path.string());
+			return {};
+		}
+
+		return resolved->Mount->Filesystem->ReadChunk(resolved->Target, offset, count);
+	}
+
+	void VirtualFilesystem::WriteFile(const Path& path, const std::vector<UInt8>& data) {
+		const auto resolved = ResolveWritable(path);
+		if (!resolved) {
+			Log::Error("Can't write \"{}\", it isn't in a writable mount.", path.string());
+			return;
+		}
+
+		resolved->Mount->Filesystem->WriteFile(resolved->Target, data);
+
+		// The written file may now shadow the one it was resolved to
+		const std::string normalizedPath = NormalizePath(path);
+
+		std::unique_lock lock{m_Mutex};
+		m_Cache.erase(normalizedPath);
+		++m_Generation;
+	}
+
+	void VirtualFilesystem::Remove(const Path& path) {
+		const auto resolved = ResolveWritable(path);
+		if (!resolved) {
+			Log::Error("Can't remove \"{}\", it isn't in a writable mount.", path.string());
+			return;
+		}
+
+		resolved->Mount->Filesystem->Remove(resolved->Target);
+
+		// A whole directory may have been removed
+		std::unique_lock lock{m_Mutex};
+		InvalidateCache();
+	}
+
+	MappedFile VirtualFilesystem::MapFile(const Path& path) {
+		const auto resolved = Resolve(path);
+		if (!resolved) {
+			Log::Error("Can't map \"{}\", it isn't in any mount.", path.string());
+			return {};
+		}
+
+		return resolved->Mount->Filesystem->MapFile(resolved->Target);
+	}
+
+	std::vector<VirtualFilesystem::MountPointPtr> VirtualFilesystem::FindMounts(
+		const std::string_view normalizedPath) const {
+		std::vector<MountPointPtr> mounts;
+
+		// The path itself may be a mount, then each of its parents up to the root
+		for (std::string_view directory = normalizedPath;;) {
+			if (const auto it = m_Mounts.find(StableHash(directory)); it != m_Mounts.end()) {
+				for (const auto& mount : it->second) {
+					if (mount->Directory == directory) {
+						mounts.push_back(mount);
+					}
+				}
+			}
+
+			const USize separator = directory.rfind('/');
+			if (separator == std::string_view::npos || directory.size() == 1) {
+				break;
+			}
+
+			// The root keeps its slash
+			directory = directory.substr(0, std::max<USize>(separator, 1));
+		}
+
+		std::ranges::sort(mounts, [](const MountPointPtr& lhs, const MountPointPtr& rhs) {
+			return std::tuple{lhs->Priority, lhs->Directory.size(), lhs->Order} >
+			       std::tuple{rhs->Priority, rhs->Directory.size(), rhs->Order};
+		});
+
+		return mounts;
+	}
+
+	void VirtualFilesystem::InvalidateCache() {
+		m_Cache.clear();
+		++m_Generation;
+	}
+
+	std::optional<VirtualFilesystem::ResolvedPath> VirtualFilesystem::Resolve(const Path& path) {
+		std::string normalizedPath = NormalizePath(path);
+
+		std::vector<MountPointPtr> mounts;
+		UInt64 generation;
+
+		{
+			std::shared_lock lock{m_Mutex};
+
+			if (const auto it = m_Cache.find(normalizedPath); it != m_Cache.end()) {
+				return it->second;
+			}
+
+			mounts = FindMounts(normalizedPath);
+			generation = m_Generation;
+		}
+
+		// The mounted filesystems are queried without the lock, a slow disk doesn't stall the other lookups
+		for (auto& mount : mounts) {
+			Path target = Translate(*mount, normalizedPath);
+
+			if (mount->Filesystem->Exists(target)) {
+				ResolvedPath resolved{std::move(mount), std::move(target)};
+
+				std::unique_lock lock{m_Mutex};
+				if (m_Generation == generation) {
+					m_Cache.try_emplace(std::move(normalizedPath), resolved);
+				}
+
+				return resolved;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	std::optional<VirtualFilesystem::ResolvedPath> VirtualFilesystem::ResolveWritable(const Path& path) const {
+		const std::string normalizedPath = NormalizePath(path);
+
+		std::shared_lock lock{m_Mutex};
+
+		for (auto& mount : FindMounts(normalizedPath)) {
+			if (!mount->ReadOnly) {
+				return ResolvedPath{mount, Translate(*mount, normalizedPath)};
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	Path VirtualFilesystem::Translate(const MountPoint& mount, const std::string_view normalizedPath) {
+		if (mount.Root.empty()) {
+			return Path{normalizedPath};
+		}
+
+		// Skips the directory of the mount and the separator following it, the root ending with its own
+		std::string_view relativePath = normalizedPath.substr(mount.Directory.size());
+		if (relativePath.starts_with('/')) {
+			relativePath.remove_prefix(1);
+		}
+
+		return relativePath.empty() ? mount.Root : mount.Root / relativePath;
+	}
+}
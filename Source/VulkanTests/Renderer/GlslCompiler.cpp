@@ -4,10 +4,21 @@
 
 #include <VulkanTests/Renderer/GlslCompiler.hpp>
 
+#include <VulkanTests/Core/Profiling.hpp>
+
+#include <VulkanTests/Renderer/GlslangSession.hpp>
+#include <VulkanTests/Renderer/ShaderCache.hpp>
+#include <VulkanTests/Renderer/SpirvOptimizer.hpp>
+#include <VulkanTests/Renderer/SpirvValidator.hpp>
+
 #include <glslang/SPIRV/GlslangToSpv.h>
 #include <glslang/Public/ResourceLimits.h>
 #include <glslang/StandAlone/DirStackFileIncluder.h>
 
+#include <charconv>
+#include <regex>
+#include <sstream>
+
 namespace VkTests {
     namespace {
         EShLanguage FindShaderLanguage(const VkShaderStageFlagBits stage) {
@@ -58,32 +69,148 @@ namespace VkTests {
                 return EShLangVertex;
             }
         }
+
+        // The Vulkan environments also check the rules Vulkan adds to SPIR-V, each accepts the SPIR-V versions
+        // its Vulkan version does
+        spv_target_env FindTargetEnvironment(const glslang::EShTargetLanguageVersion targetLanguageVersion) {
+            switch (targetLanguageVersion) {
+            case glslang::EShTargetSpv_1_1:
+            case glslang::EShTargetSpv_1_2:
+            case glslang::EShTargetSpv_1_3:
+                return SPV_ENV_VULKAN_1_1;
+
+            case glslang::EShTargetSpv_1_4:
+                return SPV_ENV_VULKAN_1_1_SPIRV_1_4;
+
+            case glslang::EShTargetSpv_1_5:
+                return SPV_ENV_VULKAN_1_2;
+
+            case glslang::EShTargetSpv_1_6:
+                return SPV_ENV_VULKAN_1_3;
+
+            default:
+                // glslang generates SPIR-V 1.0 for Vulkan 1.0 when no target is set
+                return SPV_ENV_VULKAN_1_0;
+            }
+        }
+
+        // Extracts the located messages of a glslang log, such as
+        // "ERROR: shaders/base.frag:12: 'x' : undeclared identifier"
+        void ParseInfoLog(const std::string& infoLog, std::vector<ShaderDiagnostic>& diagnostics) {
+            static const std::regex linePattern{R"(^(ERROR|WARNING|NOTE|INFO): (.*?):(\d+): (.*)$)"};
+
+            std::istringstream stream{infoLog};
+            std::string line;
+            std::smatch match;
+
+            while (std::getline(stream, line)) {
+                if (!std::regex_match(line, match, linePattern)) {
+                    continue;
+                }
+
+                // A #line directive may set any number, the lines out of range are skipped rather than thrown on
+                ShaderDiagnostic diagnostic{};
+                const std::string lineNumber = match[3].str();
+                if (std::from_chars(lineNumber.data(), lineNumber.data() + lineNumber.size(), diagnostic.Line).ec !=
+                    std::errc{}) {
+                    continue;
+                }
+
+                diagnostic.File = match[2].str();
+                diagnostic.Message = match[4].str();
+
+                if (match[1] == "ERROR") {
+                    diagnostic.Severity = ShaderDiagnosticSeverity::Error;
+                } else if (match[1] == "WARNING") {
+                    diagnostic.Severity = ShaderDiagnosticSeverity::Warning;
+                } else {
+                    diagnostic.Severity = ShaderDiagnosticSeverity::Info;
+                }
+
+                diagnostics.push_back(std::move(diagnostic));
+            }
+        }
+
+        // Switches the shader to glslang's HLSL front end. HLSL resources and stage variables may come without
+        // explicit bindings and locations, glslang assigns them in declaration order like the HLSL compilers do.
+        void SetupSourceLanguage(glslang::TShader& shader, const EShLanguage stage, const ShadingLanguage language,
+                                 EShMessages& messages) {
+            if (language != ShadingLanguage::Hlsl) {
+                return;
+            }
+
+            shader.setEnvInput(glslang::EShSourceHlsl, stage, glslang::EShClientVulkan, 100);
+            shader.setAutoMapBindings(true);
+            shader.setAutoMapLocations(true);
+            messages = static_cast<EShMessages>(messages | EShMsgReadHlsl);
+        }
+
+        // Hands the segments to glslang as views into the expanded buffer, no copy of the source is made.
+        // Must outlive the glslang shader it is applied to.
+        struct ShaderStrings {
+            std::vector<const char*> Strings;
+            std::vector<Int32> Lengths;
+            std::vector<const char*> Names;
+
+            explicit ShaderStrings(const ExpandedShaderSource& glslSource) {
+                const USize segmentCount = glslSource.Segments.size();
+
+                Strings.resize(segmentCount);
+                Lengths.resize(segmentCount);
+                Names.resize(segmentCount);
+
+                for (USize i = 0; i < segmentCount; ++i) {
+                    const auto& segment = glslSource.Segments[i];
+                    Strings[i] = glslSource.Buffer.data() + segment.Offset;
+                    Lengths[i] = static_cast<Int32>(segment.Length);
+                    Names[i] = glslSource.Files[segment.File].c_str();
+                }
+            }
+
+            void Apply(glslang::TShader& shader) const {
+                shader.setStringsWithLengthsAndNames(Strings.data(), Lengths.data(), Names.data(),
+                                                     static_cast<Int32>(Strings.size()));
+            }
+        };
     }
 
     glslang::EShTargetLanguage GlslCompiler::m_SEnvTargetLanguage = glslang::EShTargetLanguage::EShTargetNone;
     glslang::EShTargetLanguageVersion GlslCompiler::m_SEnvTargetLanguageVersion = static_cast<
         glslang::EShTargetLanguageVersion>(0);
 
-    bool GlslCompiler::CompileToSpirv(VkShaderStageFlagBits stage, const std::vector<UInt8>& glslSource,
+    bool GlslCompiler::CompileToSpirv(VkShaderStageFlagBits stage, const ExpandedShaderSource& glslSource,
                                       const std::string& entryPoint, const ShaderVariant& shaderVariant,
-                                      std::vector<UInt32>& spirv, std::string& infoLog) {
-        // Initialize the glslang library
-        glslang::InitializeProcess();
+                                      std::vector<UInt32>& spirv, std::string& infoLog,
+                                      std::vector<ShaderDiagnostic>& diagnostics, ShaderCompileStats* stats) {
+        PROFILE_FUNCTION();
+
+        // A warm cache skips glslang entirely
+        const Hash128 cacheKey = ShaderCache::ComputeKey(stage, entryPoint, shaderVariant, glslSource.Buffer,
+                                                         glslSource.Language, m_SEnvTargetLanguage,
+                                                         m_SEnvTargetLanguageVersion);
+        if (ShaderCache::Load(cacheKey, spirv)) {
+            if (stats) {
+                stats->CacheHit = true;
+            }
+            return true;
+        }
+
+        // Keep the glslang library initialized until we return, whichever path we return from
+        const auto session = GlslangSession::Acquire();
 
         auto messages = static_cast<EShMessages>(EShMsgDefault | EShMsgVulkanRules | EShMsgSpvRules);
 
         EShLanguage language = FindShaderLanguage(stage);
-        auto source = std::string(glslSource.begin(), glslSource.end());
 
-        const char* filenameList[1] = {""};
-        const char* shaderSource = source.c_str();
+        ShaderStrings strings{glslSource};
 
         glslang::TShader shader(language);
-        shader.setStringsWithLengthsAndNames(&shaderSource, nullptr, filenameList, 1);
+        strings.Apply(shader);
         shader.setEntryPoint(entryPoint.c_str());
         shader.setSourceEntryPoint(entryPoint.c_str());
         shader.setPreamble(shaderVariant.GetPreamble().c_str());
         shader.addProcesses(shaderVariant.GetProcesses());
+        SetupSourceLanguage(shader, language, glslSource.Language, messages);
         if (m_SEnvTargetLanguage != glslang::EShTargetLanguage::EShTargetNone) {
             shader.setEnvTarget(m_SEnvTargetLanguage, m_SEnvTargetLanguageVersion);
         }
@@ -91,8 +218,16 @@ namespace VkTests {
         DirStackFileIncluder includeDir;
         includeDir.pushExternalLocalDirectory("shaders");
 
-        if (!shader.parse(GetDefaultResources(), 100, false, messages, includeDir)) {
+        bool parsed;
+        {
+            PROFILE_SCOPE("glslang parse");
+            ShaderStatsTimer timer{stats ? &stats->ParseTime : nullptr};
+            parsed = shader.parse(GetDefaultResources(), 100, false, messages, includeDir);
+        }
+
+        if (!parsed) {
             infoLog = std::string(shader.getInfoLog()) + "\n" + std::string(shader.getInfoDebugLog());
+            ParseInfoLog(shader.getInfoLog(), diagnostics);
             return false;
         }
 
@@ -101,18 +236,28 @@ namespace VkTests {
         program.addShader(&shader);
 
         // Link program
-        if (!program.link(messages)) {
+        bool linked;
+        {
+            PROFILE_SCOPE("glslang link");
+            ShaderStatsTimer timer{stats ? &stats->LinkTime : nullptr};
+            linked = program.link(messages);
+        }
+
+        if (!linked) {
             infoLog = std::string(program.getInfoLog()) + "\n" + std::string(program.getInfoDebugLog());
+            ParseInfoLog(program.getInfoLog(), diagnostics);
             return false;
         }
 
         // Save any info log that was generated
         if (shader.getInfoLog()) {
             infoLog += std::string(shader.getInfoLog()) + "\n" + std::string(shader.getInfoDebugLog()) + "\n";
+            ParseInfoLog(shader.getInfoLog(), diagnostics);
         }
 
         if (program.getInfoLog()) {
             infoLog += std::string(program.getInfoLog()) + "\n" + std::string(program.getInfoDebugLog());
+            ParseInfoLog(program.getInfoLog(), diagnostics);
         }
 
         glslang::TIntermediate* intermediate = program.getIntermediate(language);
@@ -123,14 +268,80 @@ namespace VkTests {
             return false;
         }
 
-        spv::SpvBuildLogger logger;
+        {
+            PROFILE_SCOPE("SPIR-V generation");
+            ShaderStatsTimer timer{stats ? &stats->SpirvGenerationTime : nullptr};
+
+            spv::SpvBuildLogger logger;
+
+            glslang::GlslangToSpv(*intermediate, spirv, &logger);
+
+            infoLog += logger.getAllMessages() + "\n";
+        }
+
+        const spv_target_env targetEnvironment = FindTargetEnvironment(m_SEnvTargetLanguageVersion);
+
+        bool optimized;
+        {
+            PROFILE_SCOPE("SPIR-V optimization");
+            ShaderStatsTimer timer{stats ? &stats->OptimizationTime : nullptr};
+
+            // Optimize before caching, a cache hit then returns the optimized module directly
+            optimized = (glslSource.Language != ShadingLanguage::Hlsl ||
+                         SpirvOptimizer::Legalize(targetEnvironment, spirv, infoLog)) &&
+                        SpirvOptimizer::Optimize(targetEnvironment, shaderVariant, spirv, infoLog, stats);
+        }
+
+        if (!optimized) {
+            return false;
+        }
+
+#ifdef VK_TESTS_SHADER_VALIDATION
+        bool valid;
+        {
+            PROFILE_SCOPE("SPIR-V validation");
+            ShaderStatsTimer timer{stats ? &stats->ValidationTime : nullptr};
 
-        glslang::GlslangToSpv(*intermediate, spirv, &logger);
+            // Only valid modules are cached, so a cache hit doesn't need to be validated again
+            valid = SpirvValidator::Validate(targetEnvironment, spirv, infoLog, diagnostics);
+        }
 
-        infoLog += logger.getAllMessages() + "\n";
+        if (!valid) {
+            return false;
+        }
+#endif
+
+        ShaderCache::Store(cacheKey, spirv);
+
+        return true;
+    }
 
-        // Shutdown glslang library.
-        glslang::FinalizeProcess();
+    bool GlslCompiler::Preprocess(const VkShaderStageFlagBits stage, const ExpandedShaderSource& glslSource,
+                                  const ShaderVariant& shaderVariant, std::string& output, std::string& infoLog) {
+        const auto session = GlslangSession::Acquire();
+
+        auto messages = static_cast<EShMessages>(EShMsgDefault | EShMsgVulkanRules | EShMsgSpvRules);
+
+        ShaderStrings strings{glslSource};
+
+        const EShLanguage language = FindShaderLanguage(stage);
+
+        glslang::TShader shader(language);
+        strings.Apply(shader);
+        shader.setPreamble(shaderVariant.GetPreamble().c_str());
+        shader.addProcesses(shaderVariant.GetProcesses());
+        SetupSourceLanguage(shader, language, glslSource.Language, messages);
+        if (m_SEnvTargetLanguage != glslang::EShTargetLanguage::EShTargetNone) {
+            shader.setEnvTarget(m_SEnvTargetLanguage, m_SEnvTargetLanguageVersion);
+        }
+
+        DirStackFileIncluder includeDir;
+        includeDir.pushExternalLocalDirectory("shaders");
+
+        if (!shader.preprocess(GetDefaultResources(), 100, ENoProfile, false, false, messages, &output, includeDir)) {
+            infoLog = std::string(shader.getInfoLog()) + "\n" + std::string(shader.getInfoDebugLog());
+            return false;
+        }
 
         return true;
     }
@@ -0,0 +1,33 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#include <VulkanTests/Renderer/GlslangSession.hpp>
+
+#include <glslang/Public/ShaderLang.h>
+
+namespace VkTests {
+    std::mutex GlslangSession::m_SMutex;
+    std::weak_ptr<GlslangSession> GlslangSession::m_SInstance;
+
+    GlslangSession::GlslangSession() {
+        glslang::InitializeProcess();
+    }
+
+    GlslangSession::~GlslangSession() {
+        glslang::FinalizeProcess();
+    }
+
+    std::shared_ptr<GlslangSession> GlslangSession::Acquire() {
+        std::lock_guard lock{m_SMutex};
+
+        auto session = m_SInstance.lock();
+        if (!session) {
+            // The constructor is private, so std::make_shared can't be used.
+            session = std::shared_ptr<GlslangSession>(new GlslangSession());
+            m_SInstance = session;
+        }
+
+        return session;
+    }
+}
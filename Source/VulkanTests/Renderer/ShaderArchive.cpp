@@ -0,0 +1,181 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#include <VulkanTests/Renderer/ShaderArchive.hpp>
+
+#include <VulkanTests/Renderer/SpirvReflection.hpp>
+
+#include <VulkanTests/Core/Logger.hpp>
+
+#include <VulkanTests/Filesystem/Filesystem.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+
+namespace VkTests {
+    std::atomic<std::shared_ptr<const ShaderArchive>> ShaderArchive::m_SMounted;
+
+    bool ShaderArchive::Open(const std::string& path) {
+        const auto fs = Filesystem::Get();
+
+        if (!fs->IsFile(path)) {
+            Log::Error("Shader archive \"{}\" doesn't exist.", path);
+            return false;
+        }
+
+        // Mapped, entries are only copied out of the archive when looked up
+        m_Data = fs->MapFile(path);
+        m_Index.clear();
+
+        const auto data = m_Data.GetData();
+
+        Header header{};
+        if (data.size() < sizeof(Header)) {
+            Log::Error("Shader archive \"{}\" is truncated.", path);
+            return false;
+        }
+
+        std::memcpy(&header, data.data(), sizeof(Header));
+
+        if (header.Magic != Magic || header.Version != Version) {
+            Log::Error("\"{}\" isn't a shader archive, or was baked by another version.", path);
+            return false;
+        }
+
+        if (header.IndexOffset > data.size() ||
+            header.EntryCount > (data.size() - header.IndexOffset) / sizeof(Entry)) {
+            Log::Error("Shader archive \"{}\" has an invalid index.", path);
+            return false;
+        }
+
+        if (StableHash(data.data() + header.IndexOffset, header.EntryCount * sizeof(Entry)) != header.IndexChecksum) {
+            Log::Error("Shader archive \"{}\" has a corrupted index.", path);
+            return false;
+        }
+
+        m_Index.resize(header.EntryCount);
+        std::memcpy(m_Index.data(), data.data() + header.IndexOffset, header.EntryCount * sizeof(Entry));
+
+        for (const auto& entry : m_Index) {
+            if (entry.SpirvOffset + entry.SpirvSize > header.IndexOffset ||
+                entry.ReflectionOffset + entry.ReflectionSize > header.IndexOffset ||
+                entry.SpirvSize % sizeof(UInt32) != 0) {
+                Log::Error("Shader archive \"{}\" has an entry out of bounds.", path);
+                m_Index.clear();
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool ShaderArchive::Find(const Hash128& key, ShaderCompileResult& result) const {
+        const auto it = std::ranges::lower_bound(m_Index, key, CompareKeys, &Entry::Key);
+        if (it == m_Index.end() || it->Key != key) {
+            return false;
+        }
+
+        const UInt8* data = m_Data.GetData().data();
+
+        // Checked on lookup rather than on open, so mounting doesn't read the whole archive
+        if (ComputeChecksum(data + it->SpirvOffset, it->SpirvSize, data + it->ReflectionOffset, it->ReflectionSize) !=
+            it->Checksum) {
+            Log::Error("Corrupted shader archive entry {}.", key.ToString());
+            return false;
+        }
+
+        if (!SpirvReflection::DeserializeResources(data + it->ReflectionOffset, it->ReflectionSize,
+                                                   result.Resources)) {
+            Log::Error("Corrupted reflection data in shader archive entry {}.", key.ToString());
+            return false;
+        }
+
+        result.Spirv.resize(it->SpirvSize / sizeof(UInt32));
+        std::memcpy(result.Spirv.data(), data + it->SpirvOffset, it->SpirvSize);
+
+        return true;
+    }
+
+    Hash128 ShaderArchive::ComputeKey(const VkShaderStageFlagBits stage, const std::string& filename,
+                                      const ShadingLanguage language, const std::string& entryPoint,
+                                      const ShaderVariant& shaderVariant) {
+        StreamHasher hasher;
+        hasher.UpdateValue(Version);
+        hasher.UpdateValue(static_cast<UInt32>(stage));
+        hasher.Update(filename);
+        hasher.UpdateValue(language);
+        hasher.Update(entryPoint);
+        hasher.UpdateValue(shaderVariant.GetId());
+
+        return hasher.Digest();
+    }
+
+    bool ShaderArchive::CompareKeys(const Hash128& lhs, const Hash128& rhs) {
+        return std::tie(lhs.High, lhs.Low) < std::tie(rhs.High, rhs.Low);
+    }
+
+    UInt64 ShaderArchive::ComputeChecksum(const UInt8* spirv, const USize spirvSize, const UInt8* reflection,
+                                          const USize reflectionSize) {
+        return StableHash(reflection, reflectionSize, StableHash(spirv, spirvSize));
+    }
+
+    void ShaderArchiveWriter::Add(const Hash128& key, const VkShaderStageFlagBits stage,
+                                  const ShaderCompileResult& result) {
+        m_Entries.push_back({key, stage, result.Spirv, SpirvReflection::SerializeResources(result.Resources)});
+    }
+
+    void ShaderArchiveWriter::Write(const std::string& path) const {
+        // The index is sorted by key, so that the runtime can binary search it
+        std::vector<const PendingEntry*> entries;
+        entries.reserve(m_Entries.size());
+
+        for (const auto& entry : m_Entries) {
+            entries.push_back(&entry);
+        }
+
+        std::ranges::stable_sort(entries, ShaderArchive::CompareKeys, &PendingEntry::Key);
+
+        const auto duplicates = std::ranges::unique(entries, {}, &PendingEntry::Key);
+        entries.erase(duplicates.begin(), duplicates.end());
+
+        std::vector<UInt8> data(sizeof(ShaderArchive::Header));
+        std::vector<ShaderArchive::Entry> index;
+        index.reserve(entries.size());
+
+        for (const auto* entry : entries) {
+            ShaderArchive::Entry indexEntry{};
+            indexEntry.Key = entry->Key;
+            indexEntry.Stage = static_cast<UInt32>(entry->Stage);
+
+            indexEntry.SpirvOffset = data.size();
+            indexEntry.SpirvSize = entry->Spirv.size() * sizeof(UInt32);
+            const auto* spirv = reinterpret_cast<const UInt8*>(entry->Spirv.data());
+            data.insert(data.end(), spirv, spirv + indexEntry.SpirvSize);
+
+            indexEntry.ReflectionOffset = data.size();
+            indexEntry.ReflectionSize = entry->Reflection.size();
+            data.insert(data.end(), entry->Reflection.begin(), entry->Reflection.end());
+
+            indexEntry.Checksum = ShaderArchive::ComputeChecksum(spirv, indexEntry.SpirvSize,
+                                                                 entry->Reflection.data(), indexEntry.ReflectionSize);
+
+            index.push_back(indexEntry);
+        }
+
+        ShaderArchive::Header header{};
+        header.Magic = ShaderArchive::Magic;
+        header.Version = ShaderArchive::Version;
+        header.EntryCount = index.size();
+        header.IndexOffset = data.size();
+        header.IndexChecksum = StableHash(index.data(), index.size() * sizeof(ShaderArchive::Entry));
+
+        std::memcpy(data.data(), &header, sizeof(ShaderArchive::Header));
+
+        const auto* indexBytes = reinterpret_cast<const UInt8*>(index.data());
+        data.insert(data.end(), indexBytes, indexBytes + index.size() * sizeof(ShaderArchive::Entry));
+
+        Filesystem::Get()->WriteFile(path, data);
+    }
+}
@@ -0,0 +1,205 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#include <VulkanTests/Renderer/ShaderCache.hpp>
+
+#include <VulkanTests/Renderer/SpirvReflection.hpp>
+
+#include <VulkanTests/Core/Logger.hpp>
+
+#include <VulkanTests/Filesystem/Assets.hpp>
+
+#include <VulkanTests/Utils/Hash.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace VkTests {
+    namespace {
+        constexpr UInt32 CacheMagic = 0x43535356; // "VSSC"
+        constexpr UInt32 CacheVersion = 3;
+
+        // Only valid modules are cached by validating builds, they mustn't reuse entries of the other builds
+#ifdef VK_TESTS_SHADER_VALIDATION
+        constexpr bool ValidationEnabled = true;
+#else
+        constexpr bool ValidationEnabled = false;
+#endif
+
+        struct ShaderCacheHeader {
+            UInt32 Magic;
+            UInt32 Version;
+            Hash128 Key;
+            UInt64 PayloadSize;
+            UInt64 Checksum;
+        };
+    }
+
+    std::atomic<bool> ShaderCache::m_SEnabled{true};
+
+    Hash128 ShaderCache::ComputeKey(const VkShaderStageFlagBits stage, const std::string& entryPoint,
+                                    const ShaderVariant& shaderVariant, const std::string_view source,
+                                    const ShadingLanguage language, const glslang::EShTargetLanguage targetLanguage,
+                                    const glslang::EShTargetLanguageVersion targetLanguageVersion) {
+        StreamHasher hasher;
+        hasher.UpdateValue(CacheVersion);
+        hasher.UpdateValue(static_cast<UInt32>(stage));
+        hasher.Update(entryPoint);
+        hasher.Update(shaderVariant.GetPreamble());
+        hasher.UpdateValue(shaderVariant.GetOptimizationLevel());
+        hasher.UpdateValue(shaderVariant.GetStripDebugInfo());
+        hasher.UpdateValue(shaderVariant.GetRemap());
+        hasher.UpdateValue(shaderVariant.GetFreezeSpecializationConstants());
+        if (shaderVariant.GetFreezeSpecializationConstants()) {
+            for (const auto& [constantId, value] : shaderVariant.GetSpecializationConstants()) {
+                hasher.UpdateValue(constantId);
+                hasher.UpdateValue(value.Bits);
+                hasher.UpdateValue(value.Size);
+            }
+        }
+        hasher.Update(source);
+        hasher.UpdateValue(language);
+        hasher.UpdateValue(static_cast<Int32>(targetLanguage));
+        hasher.UpdateValue(static_cast<Int32>(targetLanguageVersion));
+        hasher.UpdateValue(ValidationEnabled);
+
+        return hasher.Digest();
+    }
+
+    Hash128 ShaderCache::ComputeReflectionKey(const VkShaderStageFlagBits stage, const std::vector<UInt32>& spirv,
+                                              const ShaderVariant& shaderVariant) {
+        StreamHasher hasher;
+        hasher.UpdateValue(CacheVersion);
+        hasher.UpdateValue(static_cast<UInt32>(stage));
+        hasher.Update(std::span{spirv});
+
+        // The map's iteration order is unspecified, the sizes are hashed sorted by name
+        std::vector<std::pair<std::string_view, USize>> runtimeArraySizes{
+            shaderVariant.GetRuntimeArraySizes().begin(), shaderVariant.GetRuntimeArraySizes().end()
+        };
+        std::ranges::sort(runtimeArraySizes);
+
+        for (const auto& [name, size] : runtimeArraySizes) {
+            hasher.Update(name);
+            hasher.UpdateValue(static_cast<UInt64>(size));
+        }
+
+        return hasher.Digest();
+    }
+
+    bool ShaderCache::Load(const Hash128& key, std::vector<UInt32>& spirv) {
+        std::vector<UInt8> payload;
+        if (!ReadEntry(key, ".spvc", payload)) {
+            return false;
+        }
+
+        if (payload.size() % sizeof(UInt32) != 0) {
+            Log::Warn("Discarding invalid shader cache entry {}.", key.ToString());
+            return false;
+        }
+
+        spirv.resize(payload.size() / sizeof(UInt32));
+        std::memcpy(spirv.data(), payload.data(), payload.size());
+
+        return true;
+    }
+
+    void ShaderCache::Store(const Hash128& key, const std::vector<UInt32>& spirv) {
+        WriteEntry(key, ".spvc", spirv.data(), spirv.size() * sizeof(UInt32));
+    }
+
+    bool ShaderCache::LoadReflection(const Hash128& key, std::vector<ShaderResource>& resources) {
+        std::vector<UInt8> payload;
+        if (!ReadEntry(key, ".refl", payload)) {
+            return false;
+        }
+
+        if (!SpirvReflection::DeserializeResources(payload.data(), payload.size(), resources)) {
+            Log::Warn("Discarding invalid shader reflection cache entry {}.", key.ToString());
+            resources.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    void ShaderCache::StoreReflection(const Hash128& key, const std::vector<ShaderResource>& resources) {
+        if (!IsEnabled()) {
+            return;
+        }
+
+        const auto payload = SpirvReflection::SerializeResources(resources);
+        WriteEntry(key, ".refl", payload.data(), payload.size());
+    }
+
+    bool ShaderCache::ReadEntry(const Hash128& key, const std::string_view extension, std::vector<UInt8>& payload) {
+        if (!IsEnabled()) {
+            return false;
+        }
+
+        const auto fs = Filesystem::Get();
+        const auto path = GetEntryPath(key, extension);
+
+        if (!fs->IsFile(path)) {
+            return false;
+        }
+
+        const auto data = fs->ReadFileBinary(path);
+
+        ShaderCacheHeader header{};
+        if (data.size() < sizeof(ShaderCacheHeader)) {
+            Log::Warn("Discarding truncated shader cache entry \"{}\".", path);
+            return false;
+        }
+
+        std::memcpy(&header, data.data(), sizeof(ShaderCacheHeader));
+
+        const USize payloadSize = data.size() - sizeof(ShaderCacheHeader);
+        if (header.Magic != CacheMagic || header.Version != CacheVersion || header.Key != key ||
+            header.PayloadSize != payloadSize) {
+            Log::Warn("Discarding invalid shader cache entry \"{}\".", path);
+            return false;
+        }
+
+        const UInt8* payloadData = data.data() + sizeof(ShaderCacheHeader);
+        if (StableHash(payloadData, payloadSize) != header.Checksum) {
+            Log::Warn("Discarding corrupted shader cache entry \"{}\".", path);
+            return false;
+        }
+
+        payload.assign(payloadData, payloadData + payloadSize);
+
+        return true;
+    }
+
+    void ShaderCache::WriteEntry(const Hash128& key, const std::string_view extension, const void* payload,
+                                 const USize payloadSize) {
+        if (!IsEnabled()) {
+            return;
+        }
+
+        ShaderCacheHeader header{};
+        header.Magic = CacheMagic;
+        header.Version = CacheVersion;
+        header.Key = key;
+        header.PayloadSize = payloadSize;
+        header.Checksum = StableHash(payload, payloadSize);
+
+        std::vector<UInt8> data(sizeof(ShaderCacheHeader) + payloadSize);
+        std::memcpy(data.data(), &header, sizeof(ShaderCacheHeader));
+        std::memcpy(data.data() + sizeof(ShaderCacheHeader), payload, payloadSize);
+
+        Filesystem::Get()->WriteFile(GetEntryPath(key, extension), data);
+    }
+
+    std::string ShaderCache::GetEntryPath(const Hash128& key, const std::string_view extension) {
+        const auto directory = Filesystem::Paths::Get(Filesystem::Paths::Type::Storage) + "ShaderCache/";
+
+        if (!Filesystem::IsDirectory(directory) && !Filesystem::CreateDirectory(directory)) {
+            Log::Error("Failed to create shader cache directory \"{}\".", directory);
+        }
+
+        return directory + key.ToString() + std::string{extension};
+    }
+}
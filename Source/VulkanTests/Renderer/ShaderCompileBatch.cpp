@@ -0,0 +1,47 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#include <VulkanTests/Renderer/ShaderCompileBatch.hpp>
+
+#include <VulkanTests/Renderer/GlslangSession.hpp>
+
+namespace VkTests {
+    USize ShaderCompileBatch::Add(const VkShaderStageFlagBits stage, const ShaderSource& source,
+                                  const std::string& entryPoint, const ShaderVariant& variant) {
+        m_Requests.push_back({stage, source, entryPoint, variant});
+
+        return m_Requests.size() - 1;
+    }
+
+    std::vector<ShaderCompileResult> ShaderCompileBatch::Compile(ThreadPool& threadPool) const {
+        assert(!threadPool.IsWorkerThread() && "Waiting on the thread pool from one of its workers can deadlock.");
+
+        // Keep glslang initialized for the whole batch rather than for each shader.
+        const auto session = GlslangSession::Acquire();
+
+        std::vector<std::future<ShaderCompileResult>> futures;
+        futures.reserve(m_Requests.size());
+
+        for (const auto& request : m_Requests) {
+            futures.push_back(threadPool.Submit([&request] {
+                return ShaderModule::Compile(request.Stage, request.Source, request.EntryPoint, request.Variant);
+            }));
+        }
+
+        std::vector<ShaderCompileResult> results;
+        results.reserve(m_Requests.size());
+
+        for (auto& future : futures) {
+            try {
+                results.push_back(future.get());
+            } catch (const std::exception& e) {
+                ShaderCompileResult result{};
+                result.InfoLog = e.what();
+                results.push_back(std::move(result));
+            }
+        }
+
+        return results;
+    }
+}
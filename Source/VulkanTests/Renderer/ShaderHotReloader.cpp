@@ -0,0 +1,232 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#include <VulkanTests/Renderer/ShaderHotReloader.hpp>
+
+#include <VulkanTests/Renderer/GlslangSession.hpp>
+#include <VulkanTests/Renderer/ShaderIncludeResolver.hpp>
+
+#include <VulkanTests/Core/Logger.hpp>
+
+#include <VulkanTests/Filesystem/Assets.hpp>
+
+#include <ranges>
+
+#ifdef VK_TESTS_PLATFORM_UNIX
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace VkTests {
+    ShaderHotReloader::ShaderHotReloader() : m_GlslangSession{GlslangSession::Acquire()} {
+        const std::filesystem::path root = Filesystem::Paths::Get(Filesystem::Paths::Type::Shaders);
+
+        m_Thread = std::thread([this, root] {
+            WatchLoop(root);
+        });
+    }
+
+    ShaderHotReloader::~ShaderHotReloader() {
+        m_Running = false;
+        m_Thread.join();
+    }
+
+    ShaderHotReloader::Handle ShaderHotReloader::Watch(const std::shared_ptr<ShaderModule>& module,
+                                                       const ShaderSource& glslSource,
+                                                       const ShaderVariant& shaderVariant) {
+        auto shader = std::make_shared<WatchedShader>();
+        shader->Module = module;
+        shader->Stage = module->GetStage();
+        shader->Filename = glslSource.GetFilename();
+        shader->Language = glslSource.GetLanguage();
+        shader->EntryPoint = module->GetEntryPoint();
+        shader->Variant = shaderVariant;
+
+        std::lock_guard lock{m_Mutex};
+
+        const Handle handle = m_NextHandle++;
+        m_Shaders.emplace(handle, std::move(shader));
+
+        return handle;
+    }
+
+    void ShaderHotReloader::Unwatch(const Handle handle) {
+        std::lock_guard lock{m_Mutex};
+        m_Shaders.erase(handle);
+    }
+
+    USize ShaderHotReloader::ApplyReloads(const ReloadCallback& callback) {
+        std::lock_guard lock{m_Mutex};
+
+        USize reloadCount = 0;
+        for (auto it = m_Shaders.begin(); it != m_Shaders.end();) {
+            const auto& shader = it->second;
+
+            // Modules destroyed without being unwatched are forgotten
+            const auto module = shader->Module.lock();
+            if (!module) {
+                it = m_Shaders.erase(it);
+                continue;
+            }
+
+            if (const auto result = shader->Pending.exchange(nullptr)) {
+                module->Reload(std::move(*result));
+
+                if (callback) {
+                    callback(*module);
+                }
+
+                ++reloadCount;
+            }
+
+            ++it;
+        }
+
+        return reloadCount;
+    }
+
+    void ShaderHotReloader::WatchLoop(const std::filesystem::path& root) {
+        std::set<std::string> changedFiles;
+
+#ifdef VK_TESTS_PLATFORM_UNIX
+        const int inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotify < 0) {
+            Log::Error("Failed to initialize inotify, shader hot-reload is disabled.");
+            return;
+        }
+
+        // inotify isn't recursive, every directory is watched on its own.
+        std::unordered_map<int, std::string> directories;
+        const auto addWatch = [&](const std::filesystem::path& directory) {
+            const int watch = inotify_add_watch(inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+            if (watch < 0) {
+                Log::Warn("Failed to watch shader directory \"{}\".", directory.string());
+                return;
+            }
+
+            const auto relative = std::filesystem::relative(directory, root).generic_string();
+            directories[watch] = relative == "." ? "" : relative + "/";
+        };
+
+        addWatch(root);
+
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(root, ec)) {
+            if (entry.is_directory()) {
+                addWatch(entry.path());
+            }
+        }
+
+        alignas(inotify_event) char buffer[4096];
+
+        while (m_Running) {
+            // Editors often save a file in several steps, so changes are only processed once events settle down.
+            pollfd pollDescriptor{inotify, POLLIN, 0};
+            if (poll(&pollDescriptor, 1, changedFiles.empty() ? 100 : 50) > 0) {
+                ssize_t length;
+                while ((length = read(inotify, buffer, sizeof(buffer))) > 0) {
+                    for (const char* it = buffer; it < buffer + length;) {
+                        const auto* event = reinterpret_cast<const inotify_event*>(it);
+                        it += sizeof(inotify_event) + event->len;
+
+                        const auto directory = directories.find(event->wd);
+                        if (event->len == 0 || directory == directories.end()) {
+                            continue;
+                        }
+
+                        const auto path = directory->second + event->name;
+
+                        if (event->mask & IN_ISDIR) {
+                            if (event->mask & IN_CREATE) {
+                                addWatch(root / path);
+                            }
+                        } else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+                            changedFiles.insert(path);
+                        }
+                    }
+                }
+
+                continue;
+            }
+
+            if (!changedFiles.empty()) {
+                Recompile(changedFiles);
+                changedFiles.clear();
+            }
+        }
+
+        close(inotify);
+#else
+        std::unordered_map<std::string, std::filesystem::file_time_type> writeTimes;
+
+        while (m_Running) {
+            std::error_code ec;
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(root, ec)) {
+                if (!entry.is_regular_file(ec)) {
+                    continue;
+                }
+
+                const auto path = std::filesystem::relative(entry.path(), root, ec).generic_string();
+                const auto writeTime = entry.last_write_time(ec);
+
+                if (auto [it, inserted] = writeTimes.try_emplace(path, writeTime);
+                    !inserted && it->second != writeTime) {
+                    it->second = writeTime;
+                    changedFiles.insert(path);
+                }
+            }
+
+            if (!changedFiles.empty()) {
+                Recompile(changedFiles);
+                changedFiles.clear();
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        }
+#endif
+    }
+
+    void ShaderHotReloader::Recompile(const std::set<std::string>& changedFiles) {
+        auto& resolver = ShaderIncludeResolver::Get();
+
+        std::set<std::string> affectedSources{changedFiles.begin(), changedFiles.end()};
+        for (const auto& file : changedFiles) {
+            resolver.Invalidate(file);
+
+            for (auto& dependent : resolver.GetDependents(file)) {
+                affectedSources.insert(std::move(dependent));
+            }
+        }
+
+        std::vector<std::shared_ptr<WatchedShader>> affectedShaders;
+        {
+            std::lock_guard lock{m_Mutex};
+
+            for (const auto& shader : m_Shaders | std::views::values) {
+                if (affectedSources.contains(shader->Filename) && !shader->Module.expired()) {
+                    affectedShaders.push_back(shader);
+                }
+            }
+        }
+
+        // Compiled without holding the lock, so ApplyReloads() never waits on glslang.
+        for (const auto& shader : affectedShaders) {
+            Log::Info("Reloading shader \"{}\".", shader->Filename);
+
+            ShaderSource glslSource{shader->Filename};
+            glslSource.SetLanguage(shader->Language);
+            auto result = std::make_shared<ShaderCompileResult>(
+                ShaderModule::Compile(shader->Stage, glslSource, shader->EntryPoint, shader->Variant));
+
+            if (!result->Success) {
+                Log::Error("Failed to reload shader \"{}\", keeping the previous version.", shader->Filename);
+                Log::Error("{}", result->InfoLog);
+                continue;
+            }
+
+            shader->Pending.store(std::move(result));
+        }
+    }
+}
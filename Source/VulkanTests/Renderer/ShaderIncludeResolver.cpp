@@ -0,0 +1,231 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#include <VulkanTests/Renderer/ShaderIncludeResolver.hpp>
+
+#include <VulkanTests/Renderer/Strings.hpp>
+
+#include <VulkanTests/Filesystem/Assets.hpp>
+
+#include <algorithm>
+#include <cctype>
+
+namespace VkTests {
+    namespace {
+        /**
+         * @brief Get the path of an #include "file" directive.
+         * @param line The line to parse.
+         * @return The included path, or an empty string if the line isn't an include directive.
+         */
+        std::string ParseIncludePath(std::string_view line) {
+            if (!line.starts_with("#include \"")) {
+                return {};
+            }
+
+            line.remove_prefix(10);
+            if (const USize lastQuote = line.find('\"');
+                !line.empty() && lastQuote != std::string_view::npos) {
+                line = line.substr(0, lastQuote);
+            }
+
+            return std::string{line};
+        }
+
+        bool IsPragmaOnce(std::string_view line) {
+            while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) {
+                line.remove_suffix(1);
+            }
+
+            return line == "#pragma once";
+        }
+    }
+
+    ShaderIncludeResolver& ShaderIncludeResolver::Get() {
+        static ShaderIncludeResolver resolver;
+        return resolver;
+    }
+
+    bool ShaderIncludeResolver::Expand(const ShaderSource& source, ExpandedShaderSource& expanded,
+                                       std::string& infoLog) {
+        expanded.Buffer.clear();
+        expanded.Segments.clear();
+        expanded.Files.clear();
+        expanded.Language = source.GetLanguage();
+
+        const std::string_view text = source.GetSource();
+        expanded.Buffer.reserve(text.size());
+
+        ExpansionState state{expanded, infoLog};
+        state.Stack.push_back(source.GetFilename());
+        expanded.Files.push_back(source.GetFilename());
+
+        if (!ExpandFile(text, Parse(text), state)) {
+            return false;
+        }
+
+        std::lock_guard lock{m_Mutex};
+        m_Dependencies[source.GetFilename()] = std::move(state.Dependencies);
+
+        return true;
+    }
+
+    void ShaderIncludeResolver::Invalidate(const std::string& filename) {
+        std::lock_guard lock{m_Mutex};
+        m_Includes.erase(filename);
+    }
+
+    std::vector<std::string> ShaderIncludeResolver::GetDependencies(const std::string& filename) const {
+        std::lock_guard lock{m_Mutex};
+
+        const auto it = m_Dependencies.find(filename);
+        if (it == m_Dependencies.end()) {
+            return {};
+        }
+
+        return {it->second.begin(), it->second.end()};
+    }
+
+    std::vector<std::string> ShaderIncludeResolver::GetDependents(const std::string& filename) const {
+        std::lock_guard lock{m_Mutex};
+
+        std::vector<std::string> dependents;
+        for (const auto& [source, dependencies] : m_Dependencies) {
+            if (source == filename || dependencies.contains(filename)) {
+                dependents.push_back(source);
+            }
+        }
+
+        std::ranges::sort(dependents);
+
+        return dependents;
+    }
+
+    ShaderIncludeResolver::ParsedFile ShaderIncludeResolver::Parse(const std::string_view text) {
+        ParsedFile parsed{};
+
+        USize runStart = 0;
+        UInt32 runLine = 1;
+        UInt32 line = 1;
+
+        for (USize position = 0; position < text.size(); ++line) {
+            const USize lineEnd = std::min(text.find('\n', position), text.size());
+            const auto lineText = text.substr(position, lineEnd - position);
+            const USize next = std::min(lineEnd + 1, text.size());
+
+            const bool pragmaOnce = IsPragmaOnce(lineText);
+            if (auto include = ParseIncludePath(lineText);
+                pragmaOnce || !include.empty()) {
+                parsed.Chunks.push_back({runStart, position - runStart, runLine, std::move(include)});
+                parsed.PragmaOnce |= pragmaOnce;
+
+                runStart = next;
+                runLine = line + 1;
+            }
+
+            position = next;
+        }
+
+        parsed.Chunks.push_back({runStart, text.size() - runStart, runLine, {}});
+
+        return parsed;
+    }
+
+    void ShaderIncludeResolver::AppendSegment(ExpansionState& state, const std::string_view text,
+                                              const UInt32 firstLine, const UInt32 file) {
+        if (text.empty()) {
+            return;
+        }
+
+        auto& buffer = state.Output.Buffer;
+        const USize offset = buffer.size();
+
+        // Resume the numbering of the file, #line can't come before #version so the first segment is left alone.
+        if (offset != 0) {
+            buffer += "#line " + std::to_string(firstLine) + "\n";
+        }
+
+        buffer += text;
+
+        // The next segment must start on its own line.
+        if (buffer.back() != '\n') {
+            buffer += '\n';
+        }
+
+        state.Output.Segments.push_back({offset, buffer.size() - offset, file});
+    }
+
+    ShaderIncludeResolver::IncludeFilePtr ShaderIncludeResolver::LoadInclude(const std::string& filename) {
+        {
+            std::lock_guard lock{m_Mutex};
+
+            if (const auto it = m_Includes.find(filename);
+                it != m_Includes.end()) {
+                return it->second;
+            }
+        }
+
+        if (!Filesystem::IsFile(Filesystem::Paths::Get(Filesystem::Paths::Type::Shaders, filename))) {
+            return nullptr;
+        }
+
+        // Parsed outside the lock, if another thread was faster, its result is kept.
+        auto file = std::make_shared<IncludeFile>();
+        file->Text = Filesystem::ReadShader(filename);
+        file->Parsed = Parse(file->Text);
+
+        std::lock_guard lock{m_Mutex};
+        return m_Includes.emplace(filename, std::move(file)).first->second;
+    }
+
+    bool ShaderIncludeResolver::ExpandFile(const std::string_view text, const ParsedFile& parsed,
+                                           ExpansionState& state) {
+        auto& files = state.Output.Files;
+        const auto fileIndex = static_cast<UInt32>(std::ranges::find(files, state.Stack.back()) - files.begin());
+
+        for (const auto& chunk : parsed.Chunks) {
+            AppendSegment(state, text.substr(chunk.Offset, chunk.Length), chunk.FirstLine, fileIndex);
+
+            const auto& includePath = chunk.Include;
+            if (includePath.empty()) {
+                continue;
+            }
+
+            state.Dependencies.insert(includePath);
+
+            if (state.Once.contains(includePath)) {
+                continue;
+            }
+
+            if (std::ranges::find(state.Stack, includePath) != state.Stack.end()) {
+                state.InfoLog += "Include cycle detected: " + Join(state.Stack, " -> ") + " -> " + includePath + "\n";
+                return false;
+            }
+
+            const auto include = LoadInclude(includePath);
+            if (!include) {
+                state.InfoLog += "Failed to open include file \"" + includePath + "\" included from \"" +
+                    state.Stack.back() + "\"\n";
+                return false;
+            }
+
+            if (include->Parsed.PragmaOnce) {
+                state.Once.insert(includePath);
+            }
+
+            if (std::ranges::find(files, includePath) == files.end()) {
+                files.push_back(includePath);
+            }
+
+            state.Stack.push_back(includePath);
+
+            if (!ExpandFile(include->Text, include->Parsed, state)) {
+                return false;
+            }
+
+            state.Stack.pop_back();
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,311 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#include <VulkanTests/Renderer/ShaderLayoutGenerator.hpp>
+
+#include <spdlog/fmt/fmt.h>
+
+#include <algorithm>
+#include <cctype>
+#include <numeric>
+#include <unordered_set>
+
+namespace VkTests {
+    namespace {
+        struct Declaration {
+            std::string Type;
+            std::string Extents;
+            UInt32 Size;
+            UInt32 Alignment;
+        };
+
+        std::string MakeIdentifier(const std::string_view name, const std::string_view fallback) {
+            static const std::unordered_set<std::string_view> keywords = {
+                "alignas", "alignof", "and", "auto", "bool", "case", "catch", "char", "class", "const", "default",
+                "delete", "do", "double", "enum", "explicit", "export", "extern", "float", "friend", "goto",
+                "inline", "int", "long", "mutable", "namespace", "new", "not", "operator", "or", "private",
+                "protected", "public", "register", "short", "signed", "sizeof", "static", "template", "this",
+                "throw", "try", "typedef", "typename", "union", "unsigned", "using", "virtual", "void", "xor"
+            };
+
+            std::string identifier{name.empty() ? fallback : name};
+            for (char& c : identifier) {
+                if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_') {
+                    c = '_';
+                }
+            }
+
+            if (identifier.empty() || std::isdigit(static_cast<unsigned char>(identifier.front()))) {
+                identifier.insert(0, "_");
+            }
+
+            if (keywords.contains(identifier)) {
+                identifier += '_';
+            }
+
+            return identifier;
+        }
+
+        std::string_view GetScalarType(const ShaderBaseType type) {
+            switch (type) {
+            case ShaderBaseType::Bool:
+            case ShaderBaseType::UInt:
+                return "std::uint32_t";
+            case ShaderBaseType::Int:
+                return "std::int32_t";
+            case ShaderBaseType::Int64:
+                return "std::int64_t";
+            case ShaderBaseType::UInt64:
+                return "std::uint64_t";
+            case ShaderBaseType::Half:
+                // C++ has no portable half-precision type, the bits are kept as they are
+                return "std::uint16_t";
+            case ShaderBaseType::Float:
+                return "float";
+            case ShaderBaseType::Double:
+                return "double";
+            default:
+                return {};
+            }
+        }
+
+        UInt32 GetScalarSize(const ShaderBaseType type) {
+            switch (type) {
+            case ShaderBaseType::Half:
+                return 2;
+            case ShaderBaseType::Int64:
+            case ShaderBaseType::UInt64:
+            case ShaderBaseType::Double:
+                return 8;
+            default:
+                return 4;
+            }
+        }
+
+        bool IsRuntimeArray(const ShaderBlockMember& member) {
+            return !member.ArrayDimensions.empty() && member.ArrayDimensions.front() == 0;
+        }
+
+        // Declares a member as its scalar type, or as the given struct type, with array extents reproducing its
+        // strides. Fails if the layout can't be expressed with C++ arrays.
+        bool Declare(const ShaderBlockMember& member, const std::string& structType, const UInt32 structSize,
+                     const UInt32 structAlignment, Declaration& declaration) {
+            UInt32 componentSize = 0;
+            UInt32 elementSize;
+
+            if (member.BaseType == ShaderBaseType::Struct) {
+                declaration.Type = structType;
+                declaration.Alignment = structAlignment;
+                elementSize = structSize;
+            } else {
+                declaration.Type = GetScalarType(member.BaseType);
+                if (declaration.Type.empty()) {
+                    return false;
+                }
+
+                componentSize = GetScalarSize(member.BaseType);
+                declaration.Alignment = componentSize;
+
+                if (member.Columns > 1) {
+                    // Matrices are arrays of columns, or of rows if row-major, each padded to the matrix stride
+                    const UInt32 vectorCount = member.RowMajor ? member.VecSize : member.Columns;
+                    if (member.MatrixStride == 0 || member.MatrixStride % componentSize != 0) {
+                        return false;
+                    }
+
+                    declaration.Extents = fmt::format("[{}][{}]", vectorCount, member.MatrixStride / componentSize);
+                    elementSize = vectorCount * member.MatrixStride;
+                } else if (member.VecSize > 1) {
+                    declaration.Extents = fmt::format("[{}]", member.VecSize);
+                    elementSize = member.VecSize * componentSize;
+                } else {
+                    elementSize = componentSize;
+                }
+            }
+
+            // Innermost dimension first, the elements of the innermost one may need padding to its stride
+            for (USize dimension = member.ArrayDimensions.size(); dimension-- > 0;) {
+                const UInt32 stride = member.ArrayStrides[dimension];
+
+                if (stride != elementSize) {
+                    const bool innermost = dimension + 1 == member.ArrayDimensions.size();
+                    if (!innermost || member.Columns > 1 || componentSize == 0 || stride < elementSize ||
+                        stride % componentSize != 0) {
+                        return false;
+                    }
+
+                    declaration.Extents = fmt::format("[{}]", stride / componentSize);
+                }
+
+                declaration.Extents = fmt::format("[{}]", member.ArrayDimensions[dimension]) + declaration.Extents;
+                elementSize = stride * member.ArrayDimensions[dimension];
+            }
+
+            declaration.Size = elementSize;
+
+            return declaration.Size == member.Size;
+        }
+
+        // Writes the definition of a struct and gathers the assertions checking its layout, returns its alignment
+        UInt32 WriteStruct(std::string& out, const std::string& indent, const std::string& name,
+                           const std::string& qualifiedName, const std::vector<ShaderBlockMember>& members,
+                           const UInt32 size, std::vector<std::string>& asserts) {
+            const std::string memberIndent = indent + "    ";
+
+            std::vector<USize> order(members.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::ranges::stable_sort(order, {}, [&members](const USize i) { return members[i].Offset; });
+
+            std::string nestedTypes;
+            std::unordered_map<std::string, std::string> nestedDefinitions;
+            std::string body;
+
+            UInt32 cursor = 0;
+            UInt32 alignment = 4;
+            UInt32 paddingCount = 0;
+
+            const auto pad = [&](const UInt32 offset) {
+                if (offset > cursor) {
+                    body += fmt::format("{}std::uint8_t _pad{}[{}];\n", memberIndent, paddingCount++, offset - cursor);
+                    cursor = offset;
+                }
+            };
+
+            for (const USize index : order) {
+                const auto& member = members[index];
+                const std::string memberName = MakeIdentifier(member.Name, fmt::format("member{}", index));
+
+                if (IsRuntimeArray(member)) {
+                    body += fmt::format("{}static constexpr std::size_t {}Offset = {};\n", memberIndent, memberName,
+                                        member.Offset);
+                    body += fmt::format("{}static constexpr std::size_t {}Stride = {};\n", memberIndent, memberName,
+                                        member.ArrayStrides.front());
+                    continue;
+                }
+
+                // Struct types are nested in the struct using them, defined once per distinct layout
+                std::string structType;
+                UInt32 structSize = 0;
+                UInt32 structAlignment = 0;
+
+                if (member.BaseType == ShaderBaseType::Struct) {
+                    const std::string baseName = MakeIdentifier(member.TypeName, memberName + "Type");
+                    structSize = member.ArrayStrides.empty() ? member.Size : member.ArrayStrides.back();
+
+                    for (UInt32 suffix = 0;; ++suffix) {
+                        structType = suffix == 0 ? baseName : fmt::format("{}_{}", baseName, suffix);
+
+                        std::string definition;
+                        std::vector<std::string> nestedAsserts;
+                        structAlignment = WriteStruct(definition, memberIndent, structType,
+                                                      qualifiedName + "::" + structType, member.Members, structSize,
+                                                      nestedAsserts);
+
+                        const auto [it, inserted] = nestedDefinitions.try_emplace(structType, definition);
+                        if (inserted) {
+                            nestedTypes += definition + "\n";
+                            asserts.insert(asserts.end(), nestedAsserts.begin(), nestedAsserts.end());
+                            break;
+                        }
+
+                        if (it->second == definition) {
+                            break;
+                        }
+                    }
+                }
+
+                Declaration declaration{};
+                if (!Declare(member, structType, structSize, structAlignment, declaration)) {
+                    // Still copyable as a whole, only the access to the member is lost
+                    declaration = {"std::uint8_t", fmt::format("[{}]", member.Size), member.Size, 1};
+                }
+
+                pad(member.Offset);
+
+                body += fmt::format("{}{} {}{};\n", memberIndent, declaration.Type, memberName, declaration.Extents);
+                asserts.push_back(fmt::format("static_assert(offsetof({}, {}) == {});", qualifiedName, memberName,
+                                              member.Offset));
+
+                cursor = std::max(cursor, member.Offset + declaration.Size);
+                alignment = std::max(alignment, declaration.Alignment);
+            }
+
+            pad(size);
+
+            out += fmt::format("{}struct {} {{\n{}{}{}}};\n", indent, name, nestedTypes, body, indent);
+
+            const UInt32 alignedSize = (cursor + alignment - 1) / alignment * alignment;
+            asserts.push_back(fmt::format("static_assert(sizeof({}) == {});", qualifiedName, alignedSize));
+
+            return alignment;
+        }
+
+        std::string_view GetBlockKind(const ShaderResourceType type) {
+            switch (type) {
+            case ShaderResourceType::BufferUniform:
+                return "Uniform buffer";
+            case ShaderResourceType::BufferStorage:
+                return "Storage buffer";
+            default:
+                return "Push constants";
+            }
+        }
+    }
+
+    std::string ShaderLayoutGenerator::GenerateHeader(const std::vector<ShaderBlockLayout>& layouts,
+                                                      const std::string_view nameSpace) {
+        const std::string indent = nameSpace.empty() ? "" : "    ";
+
+        std::unordered_map<std::string, std::string> definitions;
+        std::string declarations;
+
+        for (const auto& layout : layouts) {
+            const std::string baseName = MakeIdentifier(layout.TypeName, layout.Name);
+
+            for (UInt32 suffix = 0;; ++suffix) {
+                const std::string name = suffix == 0 ? baseName : fmt::format("{}_{}", baseName, suffix);
+
+                std::string definition;
+                std::vector<std::string> asserts;
+                WriteStruct(definition, indent, name, name, layout.Members, layout.Size, asserts);
+
+                for (const auto& assertion : asserts) {
+                    definition += indent + assertion + "\n";
+                }
+
+                const auto [it, inserted] = definitions.try_emplace(name, definition);
+                if (inserted) {
+                    if (layout.Type == ShaderResourceType::PushConstant) {
+                        declarations += fmt::format("\n{}// {} \"{}\"\n", indent, GetBlockKind(layout.Type),
+                                                    layout.Name);
+                    } else {
+                        declarations += fmt::format("\n{}// {} \"{}\", set {}, binding {}\n", indent,
+                                                    GetBlockKind(layout.Type), layout.Name, layout.Set,
+                                                    layout.Binding);
+                    }
+
+                    declarations += definition;
+                    break;
+                }
+
+                if (it->second == definition) {
+                    break;
+                }
+            }
+        }
+
+        std::string header = "// Generated from the reflection of shader blocks, do not edit.\n\n"
+                             "#pragma once\n\n"
+                             "#include <cstddef>\n"
+                             "#include <cstdint>\n";
+
+        if (nameSpace.empty()) {
+            header += declarations;
+        } else {
+            header += fmt::format("\nnamespace {} {{{}}}\n", nameSpace, declarations);
+        }
+
+        return header;
+    }
+}
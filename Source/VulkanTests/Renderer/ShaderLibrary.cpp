@@ -0,0 +1,112 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#include <VulkanTests/Renderer/ShaderLibrary.hpp>
+
+#include <VulkanTests/Core/Logger.hpp>
+
+#include <VulkanTests/Utils/Hash.hpp>
+
+#include <algorithm>
+
+namespace VkTests {
+    ShaderLibrary::ShaderLibrary(Device& device, ThreadPool& threadPool) : m_Device{device},
+                                                                           m_ThreadPool{threadPool} {
+    }
+
+    ShaderLibrary::ShaderModuleFuture ShaderLibrary::Load(const VkShaderStageFlagBits stage,
+                                                          const ShaderSource& glslSource,
+                                                          const std::string& entryPoint,
+                                                          const ShaderVariant& shaderVariant,
+                                                          CompletionCallback callback) {
+        ModuleKey key{stage, glslSource.GetFilename(), glslSource.GetId(), entryPoint, shaderVariant.GetId()};
+
+        std::lock_guard lock{m_Mutex};
+
+        // A failed load whose callbacks weren't dispatched yet is retried too
+        EraseFailed(key);
+
+        auto it = m_Modules.find(key);
+        if (it == m_Modules.end()) {
+            auto future = m_ThreadPool.Submit([&device = m_Device, stage, glslSource, entryPoint, shaderVariant] {
+                return std::make_shared<ShaderModule>(device, stage, glslSource, entryPoint, shaderVariant);
+            });
+
+            it = m_Modules.emplace(std::move(key), future.share()).first;
+        }
+
+        if (callback) {
+            m_PendingCompletions.push_back({it->first, it->second, std::move(callback)});
+        }
+
+        return it->second;
+    }
+
+    USize ShaderLibrary::DispatchCompletions() {
+        std::vector<PendingCompletion> ready;
+
+        {
+            std::lock_guard lock{m_Mutex};
+
+            const auto isPending = [](const PendingCompletion& completion) {
+                return completion.Future.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+            };
+
+            const auto firstReady = std::stable_partition(m_PendingCompletions.begin(), m_PendingCompletions.end(),
+                                                          isPending);
+
+            ready.assign(std::make_move_iterator(firstReady), std::make_move_iterator(m_PendingCompletions.end()));
+            m_PendingCompletions.erase(firstReady, m_PendingCompletions.end());
+
+            for (const auto& completion : ready) {
+                EraseFailed(completion.Key);
+            }
+        }
+
+        // Callbacks run without the lock held, so they can request more modules.
+        for (auto& completion : ready) {
+            ShaderModulePtr module;
+
+            try {
+                module = completion.Future.get();
+            } catch (const std::exception& e) {
+                Log::Error("Asynchronous shader load failed: {}", e.what());
+            }
+
+            completion.Callback(module);
+        }
+
+        return ready.size();
+    }
+
+    USize ShaderLibrary::GetPendingCount() const {
+        std::lock_guard lock{m_Mutex};
+
+        return m_PendingCompletions.size();
+    }
+
+    USize ShaderLibrary::ModuleKeyHasher::operator()(const ModuleKey& key) const {
+        USize seed = 0;
+        HashCombine(seed, static_cast<UInt32>(key.Stage));
+        HashCombine(seed, key.Filename);
+        HashCombine(seed, key.SourceId);
+        HashCombine(seed, key.EntryPoint);
+        HashCombine(seed, key.VariantId);
+
+        return seed;
+    }
+
+    void ShaderLibrary::EraseFailed(const ModuleKey& key) {
+        const auto it = m_Modules.find(key);
+        if (it == m_Modules.end() || it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return;
+        }
+
+        try {
+            it->second.get();
+        } catch (const std::exception&) {
+            m_Modules.erase(it);
+        }
+    }
+}
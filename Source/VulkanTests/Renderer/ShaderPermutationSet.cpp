@@ -0,0 +1,142 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#include <VulkanTests/Renderer/ShaderPermutationSet.hpp>
+
+#include <VulkanTests/Renderer/GlslCompiler.hpp>
+#include <VulkanTests/Renderer/GlslangSession.hpp>
+#include <VulkanTests/Renderer/ShaderCompileBatch.hpp>
+#include <VulkanTests/Renderer/ShaderIncludeResolver.hpp>
+#include <VulkanTests/Renderer/Error.hpp>
+
+#include <VulkanTests/Core/Logger.hpp>
+
+namespace VkTests {
+    namespace {
+        USize GetAxisSize(const ShaderDefineAxis& axis) {
+            return axis.Values.empty() ? 2 : axis.Values.size();
+        }
+
+        struct PreprocessResult {
+            bool Success = false;
+
+            std::string Output;
+
+            std::string InfoLog;
+        };
+    }
+
+    void ShaderPermutationSet::AddAxis(const std::string& name) {
+        m_Axes.push_back({name, {}});
+        m_PermutationCount *= 2;
+    }
+
+    void ShaderPermutationSet::AddAxis(const std::string& name, const std::vector<std::string>& values) {
+        if (values.empty()) {
+            throw VulkanException{VK_ERROR_INITIALIZATION_FAILED, "Shader define axis has no values"};
+        }
+
+        m_Axes.push_back({name, values});
+        m_PermutationCount *= values.size();
+    }
+
+    ShaderVariant ShaderPermutationSet::GetVariant(USize permutation, const ShaderVariant& baseVariant) const {
+        ShaderVariant variant = baseVariant;
+
+        // The permutation index is a mixed-radix number, with one digit per axis
+        for (const auto& axis : m_Axes) {
+            const USize axisSize = GetAxisSize(axis);
+            const USize value = permutation % axisSize;
+            permutation /= axisSize;
+
+            if (axis.Values.empty()) {
+                if (value != 0) {
+                    variant.AddDefine(axis.Name);
+                }
+            } else {
+                variant.AddDefine(axis.Name + "=" + axis.Values[value]);
+            }
+        }
+
+        return variant;
+    }
+
+    ShaderPermutationResult ShaderPermutationSet::Compile(ThreadPool& threadPool, const VkShaderStageFlagBits stage,
+                                                          const ShaderSource& glslSource,
+                                                          const std::string& entryPoint,
+                                                          const ShaderVariant& baseVariant) const {
+        assert(!threadPool.IsWorkerThread() && "Waiting on the thread pool from one of its workers can deadlock.");
+
+        ShaderPermutationResult permutationResult{};
+        permutationResult.ResultIndices.resize(m_PermutationCount);
+
+        // Keep glslang initialized for the preprocessing and compilation of every permutation
+        const auto session = GlslangSession::Acquire();
+
+        // The includes are expanded once, every permutation preprocesses the same buffer
+        ExpandedShaderSource expandedSource;
+        if (std::string infoLog; !ShaderIncludeResolver::Get().Expand(glslSource, expandedSource, infoLog)) {
+            ShaderCompileResult result{};
+            result.InfoLog = std::move(infoLog);
+            permutationResult.Results.push_back(std::move(result));
+            return permutationResult;
+        }
+
+        std::vector<ShaderVariant> variants;
+        variants.reserve(m_PermutationCount);
+
+        std::vector<std::future<PreprocessResult>> futures;
+        futures.reserve(m_PermutationCount);
+
+        for (USize i = 0; i < m_PermutationCount; ++i) {
+            variants.push_back(GetVariant(i, baseVariant));
+        }
+
+        for (const auto& variant : variants) {
+            futures.push_back(threadPool.Submit([stage, &expandedSource, &variant] {
+                PreprocessResult result{};
+                result.Success = GlslCompiler::Preprocess(stage, expandedSource, variant, result.Output,
+                                                          result.InfoLog);
+                return result;
+            }));
+        }
+
+        // Permutations with the same preprocessed source share the compilation of the first one
+        ShaderCompileBatch batch;
+        std::vector<USize> batchIndices;
+        std::unordered_map<std::string, USize> uniqueSources;
+
+        for (USize i = 0; i < m_PermutationCount; ++i) {
+            auto preprocessed = futures[i].get();
+
+            if (!preprocessed.Success) {
+                ShaderCompileResult result{};
+                result.InfoLog = std::move(preprocessed.InfoLog);
+                permutationResult.ResultIndices[i] = permutationResult.Results.size();
+                permutationResult.Results.push_back(std::move(result));
+                continue;
+            }
+
+            const auto [it, inserted] = uniqueSources.try_emplace(std::move(preprocessed.Output),
+                                                                  permutationResult.Results.size());
+            if (inserted) {
+                batch.Add(stage, glslSource, entryPoint, variants[i]);
+                batchIndices.push_back(it->second);
+                permutationResult.Results.emplace_back();
+            }
+
+            permutationResult.ResultIndices[i] = it->second;
+        }
+
+        Log::Debug("Compiling {} unique permutations out of {} for shader \"{}\".", batch.GetSize(),
+                   m_PermutationCount, glslSource.GetFilename());
+
+        auto results = batch.Compile(threadPool);
+        for (USize i = 0; i < results.size(); ++i) {
+            permutationResult.Results[batchIndices[i]] = std::move(results[i]);
+        }
+
+        return permutationResult;
+    }
+}
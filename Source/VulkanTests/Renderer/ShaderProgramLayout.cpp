@@ -0,0 +1,192 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#include <VulkanTests/Renderer/ShaderProgramLayout.hpp>
+
+#include <VulkanTests/Core/Logger.hpp>
+
+#include <VulkanTests/Renderer/VkInitializers.hpp>
+
+#include <algorithm>
+#include <ranges>
+
+namespace VkTests {
+    namespace {
+        bool IsDescriptor(const ShaderResourceType type) {
+            switch (type) {
+            case ShaderResourceType::InputAttachment:
+            case ShaderResourceType::Image:
+            case ShaderResourceType::ImageSampler:
+            case ShaderResourceType::ImageStorage:
+            case ShaderResourceType::Sampler:
+            case ShaderResourceType::BufferUniform:
+            case ShaderResourceType::BufferStorage:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        VkDescriptorType GetDescriptorType(const ShaderResource& resource) {
+            const bool dynamic = resource.Mode == ShaderResourceMode::Dynamic;
+
+            switch (resource.Type) {
+            case ShaderResourceType::InputAttachment:
+                return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+            case ShaderResourceType::Image:
+                return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+            case ShaderResourceType::ImageSampler:
+                return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            case ShaderResourceType::ImageStorage:
+                return VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            case ShaderResourceType::Sampler:
+                return VK_DESCRIPTOR_TYPE_SAMPLER;
+            case ShaderResourceType::BufferUniform:
+                return dynamic ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            case ShaderResourceType::BufferStorage:
+                return dynamic ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            default:
+                return VK_DESCRIPTOR_TYPE_MAX_ENUM;
+            }
+        }
+
+        bool IsSameResource(const ShaderResource& lhs, const ShaderResource& rhs) {
+            if (IsDescriptor(lhs.Type) || IsDescriptor(rhs.Type)) {
+                return IsDescriptor(lhs.Type) && IsDescriptor(rhs.Type) && lhs.Set == rhs.Set &&
+                       lhs.Binding == rhs.Binding;
+            }
+
+            if (lhs.Type != rhs.Type || lhs.Name != rhs.Name) {
+                return false;
+            }
+
+            // The inputs of a stage and the outputs of another often share their names, but are different variables
+            if (lhs.Type == ShaderResourceType::Input || lhs.Type == ShaderResourceType::Output) {
+                return (lhs.Stages & rhs.Stages) != 0;
+            }
+
+            return true;
+        }
+    }
+
+    ShaderProgramLayout::ShaderProgramLayout() {
+        Update();
+    }
+
+    bool ShaderProgramLayout::AddShaderModule(const ShaderModule& shaderModule) {
+        return AddResources(shaderModule.GetResources());
+    }
+
+    bool ShaderProgramLayout::AddResources(const std::vector<ShaderResource>& resources) {
+        std::vector<ShaderResource> merged = m_Resources;
+        auto pushConstantStages = m_PushConstantStages;
+
+        for (const auto& resource : resources) {
+            if (resource.Type == ShaderResourceType::PushConstant) {
+                const UInt32 end = resource.Offset + resource.Size;
+
+                auto [it, inserted] = pushConstantStages.try_emplace(resource.Stages, resource.Offset, end);
+                if (!inserted) {
+                    it->second = {std::min(it->second.first, resource.Offset), std::max(it->second.second, end)};
+                }
+            }
+
+            const auto it = std::ranges::find_if(merged, [&resource](const ShaderResource& other) {
+                return IsSameResource(resource, other);
+            });
+
+            if (it == merged.end()) {
+                merged.push_back(resource);
+                continue;
+            }
+
+            if (IsDescriptor(resource.Type) &&
+                (GetDescriptorType(resource) != GetDescriptorType(*it) || resource.ArraySize != it->ArraySize)) {
+                Log::Error("Shader resource \"{}\" conflicts with \"{}\" at set {}, binding {}.", resource.Name,
+                           it->Name, resource.Set, resource.Binding);
+                return false;
+            }
+
+            if (resource.Type == ShaderResourceType::PushConstant) {
+                const UInt32 end = std::max(it->Offset + it->Size, resource.Offset + resource.Size);
+
+                it->Offset = std::min(it->Offset, resource.Offset);
+                it->Size = end - it->Offset;
+            } else {
+                // Stages may declare only the beginning of a buffer, the layout needs the largest declaration
+                it->Size = std::max(it->Size, resource.Size);
+            }
+
+            it->Stages |= resource.Stages;
+        }
+
+        m_Resources = std::move(merged);
+        m_PushConstantStages = std::move(pushConstantStages);
+
+        Update();
+
+        return true;
+    }
+
+    const std::vector<VkDescriptorSetLayoutBinding>& ShaderProgramLayout::GetSetLayoutBindings(const UInt32 set) const {
+        static const std::vector<VkDescriptorSetLayoutBinding> Empty;
+
+        const auto it = m_SetLayouts.find(set);
+
+        return it != m_SetLayouts.end() ? it->second : Empty;
+    }
+
+    void ShaderProgramLayout::Update() {
+        m_SetLayouts.clear();
+
+        for (const auto& resource : m_Resources) {
+            if (IsDescriptor(resource.Type)) {
+                m_SetLayouts[resource.Set].push_back(VkInitializers::DescriptorSetLayoutBinding(
+                    GetDescriptorType(resource), resource.Stages, resource.Binding, resource.ArraySize));
+            }
+        }
+
+        for (auto& bindings : m_SetLayouts | std::views::values) {
+            std::ranges::sort(bindings, {}, &VkDescriptorSetLayoutBinding::binding);
+        }
+
+        // Stages using the same range share it, every stage still appears in a single range
+        std::map<std::pair<UInt32, UInt32>, VkShaderStageFlags> ranges;
+        for (const auto& [stage, range] : m_PushConstantStages) {
+            ranges[range] |= stage;
+        }
+
+        m_PushConstantRanges.clear();
+        for (const auto& [range, stages] : ranges) {
+            m_PushConstantRanges.push_back(
+                VkInitializers::PushConstantRange(stages, range.second - range.first, range.first));
+        }
+
+        // Only the fields defining the layout are hashed, not the structure padding nor the immutable samplers
+        StreamHasher hasher;
+        hasher.UpdateValue(static_cast<UInt64>(m_SetLayouts.size()));
+
+        for (const auto& [set, bindings] : m_SetLayouts) {
+            hasher.UpdateValue(set);
+            hasher.UpdateValue(static_cast<UInt64>(bindings.size()));
+
+            for (const auto& binding : bindings) {
+                hasher.UpdateValue(binding.binding);
+                hasher.UpdateValue(binding.descriptorType);
+                hasher.UpdateValue(binding.descriptorCount);
+                hasher.UpdateValue(binding.stageFlags);
+            }
+        }
+
+        hasher.UpdateValue(static_cast<UInt64>(m_PushConstantRanges.size()));
+
+        for (const auto& range : m_PushConstantRanges) {
+            hasher.UpdateValue(range.stageFlags);
+            hasher.UpdateValue(range.offset);
+            hasher.UpdateValue(range.size);
+        }
+
+        m_Hash = hasher.Digest();
+    }
+}
@@ -0,0 +1,50 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#include <VulkanTests/Renderer/ShaderSpecializationInfo.hpp>
+
+#include <VulkanTests/Core/Logger.hpp>
+
+#include <cstring>
+
+namespace VkTests {
+    ShaderSpecializationInfo::ShaderSpecializationInfo(const ShaderModule& shaderModule,
+                                                       const ShaderVariant& shaderVariant)
+        : ShaderSpecializationInfo(shaderModule.GetResources(), shaderVariant) {
+    }
+
+    ShaderSpecializationInfo::ShaderSpecializationInfo(const std::vector<ShaderResource>& resources,
+                                                       const ShaderVariant& shaderVariant) {
+        const auto& values = shaderVariant.GetSpecializationConstants();
+        if (values.empty()) {
+            return;
+        }
+
+        for (const auto& resource : resources) {
+            if (resource.Type != ShaderResourceType::SpecializationConstant) {
+                continue;
+            }
+
+            const auto it = values.find(resource.ConstantId);
+            if (it == values.end()) {
+                continue;
+            }
+
+            const ShaderSpecializationValue& value = it->second;
+            if (value.Size != resource.Size) {
+                Log::Warn("Specialization constant \"{}\" (id {}) is {} bytes, the value given is {} bytes.",
+                          resource.Name, resource.ConstantId, resource.Size, value.Size);
+                continue;
+            }
+
+            // Values are aligned to their size, so the blob can also be read as an array of scalars
+            const USize offset = (m_Data.size() + value.Size - 1) / value.Size * value.Size;
+            m_Data.resize(offset + value.Size);
+            std::memcpy(m_Data.data() + offset, &value.Bits, value.Size);
+
+            m_MapEntries.push_back(VkInitializers::SpecializationMapEntry(resource.ConstantId,
+                                                                          static_cast<UInt32>(offset), value.Size));
+        }
+    }
+}
@@ -0,0 +1,115 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#include <VulkanTests/Renderer/ShaderStats.hpp>
+
+#include <VulkanTests/Core/Logger.hpp>
+
+#include <algorithm>
+
+namespace VkTests {
+    namespace {
+        double ToMilliseconds(const std::chrono::nanoseconds duration) {
+            return std::chrono::duration<double, std::milli>(duration).count();
+        }
+    }
+
+    std::atomic<bool> ShaderStats::m_SEnabled{false};
+    std::mutex ShaderStats::m_SMutex;
+    std::vector<ShaderCompileStats> ShaderStats::m_SRecords;
+
+    void ShaderStats::Record(const ShaderCompileStats& stats) {
+        if (!IsEnabled()) {
+            return;
+        }
+
+        std::lock_guard lock{m_SMutex};
+        m_SRecords.push_back(stats);
+    }
+
+    std::vector<ShaderCompileStats> ShaderStats::GetRecords() {
+        std::lock_guard lock{m_SMutex};
+        return m_SRecords;
+    }
+
+    std::vector<ShaderCompileStats> ShaderStats::GetSlowest(const USize count) {
+        std::vector<ShaderCompileStats> records = GetRecords();
+
+        const auto middle = records.begin() + static_cast<std::ptrdiff_t>(std::min(count, records.size()));
+        std::ranges::partial_sort(records, middle, std::ranges::greater{}, &ShaderCompileStats::TotalTime);
+        records.erase(middle, records.end());
+
+        return records;
+    }
+
+    ShaderStatsSummary ShaderStats::GetSummary() {
+        std::lock_guard lock{m_SMutex};
+
+        ShaderStatsSummary summary{};
+        summary.CompileCount = m_SRecords.size();
+
+        for (const auto& record : m_SRecords) {
+            summary.FailureCount += record.Success ? 0 : 1;
+            summary.CacheHitCount += record.CacheHit ? 1 : 0;
+            summary.ReflectionCacheHitCount += record.ReflectionCacheHit ? 1 : 0;
+
+            summary.IncludeExpansionTime += record.IncludeExpansionTime;
+            summary.ParseTime += record.ParseTime;
+            summary.LinkTime += record.LinkTime;
+            summary.SpirvGenerationTime += record.SpirvGenerationTime;
+            summary.OptimizationTime += record.OptimizationTime;
+            summary.ValidationTime += record.ValidationTime;
+            summary.ReflectionTime += record.ReflectionTime;
+            summary.TotalTime += record.TotalTime;
+
+            summary.OutputSize += record.OutputSize;
+            summary.OptimizedCount += record.InstructionCountBefore > 0 ? 1 : 0;
+            summary.InstructionCountBefore += record.InstructionCountBefore;
+            summary.InstructionCountAfter += record.InstructionCountAfter;
+        }
+
+        return summary;
+    }
+
+    void ShaderStats::LogSummary(const USize count) {
+        const ShaderStatsSummary summary = GetSummary();
+
+        Log::Info("Shader compilations: {} ({} failed), {} cache hits, {} reflection cache hits, {} bytes of SPIR-V.",
+                  summary.CompileCount, summary.FailureCount, summary.CacheHitCount, summary.ReflectionCacheHitCount,
+                  summary.OutputSize);
+        Log::Info("Shader compile time: {:.2f} ms (include expansion {:.2f} ms, parse {:.2f} ms, link {:.2f} ms, "
+                  "SPIR-V generation {:.2f} ms, optimization {:.2f} ms, validation {:.2f} ms, reflection {:.2f} ms).",
+                  ToMilliseconds(summary.TotalTime), ToMilliseconds(summary.IncludeExpansionTime),
+                  ToMilliseconds(summary.ParseTime), ToMilliseconds(summary.LinkTime),
+                  ToMilliseconds(summary.SpirvGenerationTime), ToMilliseconds(summary.OptimizationTime),
+                  ToMilliseconds(summary.ValidationTime), ToMilliseconds(summary.ReflectionTime));
+
+        if (summary.OptimizedCount > 0) {
+            Log::Info("Shader optimization: {} modules, {} -> {} instructions.", summary.OptimizedCount,
+                      summary.InstructionCountBefore, summary.InstructionCountAfter);
+        }
+
+        for (const auto& record : GetSlowest(count)) {
+            Log::Info("  {:.2f} ms: \"{}\" [variant: {}] [entrypoint {}]{}", ToMilliseconds(record.TotalTime),
+                      record.Filename, record.VariantId.ToString(), record.EntryPoint,
+                      record.CacheHit ? " (cached)" : "");
+        }
+    }
+
+    void ShaderStats::Clear() {
+        std::lock_guard lock{m_SMutex};
+        m_SRecords.clear();
+    }
+
+    ShaderStatsTimer::ShaderStatsTimer(std::chrono::nanoseconds* duration)
+        : m_Duration(duration), m_Start(std::chrono::steady_clock::now()) {
+    }
+
+    ShaderStatsTimer::~ShaderStatsTimer() {
+        if (m_Duration) {
+            *m_Duration += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                                 m_Start);
+        }
+    }
+}
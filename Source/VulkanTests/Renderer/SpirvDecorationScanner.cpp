@@ -0,0 +1,897 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#include <VulkanTests/Renderer/SpirvDecorationScanner.hpp>
+
+#include <VulkanTests/Core/Logger.hpp>
+
+#include <VulkanTests/Utils/Helpers.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <span>
+#include <unordered_set>
+
+namespace VkTests {
+    namespace {
+        constexpr USize HeaderWordCount = 5;
+        constexpr UInt32 MaxStructMembers = 16383;
+
+        // Each id takes at least a word to define, but the remapper spreads the ids of small modules over a few
+        // thousand values. A larger bound comes from a corrupted header.
+        constexpr USize MinIdBoundLimit = 1 << 16;
+
+        std::string_view ReadString(const UInt32* words, const UInt32 wordCount) {
+            const auto* chars = reinterpret_cast<const char*>(words);
+
+            return {chars, strnlen(chars, wordCount * sizeof(UInt32))};
+        }
+    }
+
+    bool SpirvDecorationScanner::ReflectShaderResources(const VkShaderStageFlagBits stage,
+                                                        const std::vector<UInt32>& spirv,
+                                                        std::vector<ShaderResource>& resources,
+                                                        const ShaderVariant& variant) {
+        if (!Scan(spirv)) {
+            return false;
+        }
+
+        // Buckets the resources by type, so they come out in the same order as SPIRV-Cross lists them
+        ResourceLists lists;
+        std::vector<ShaderResource> pushConstants;
+
+        for (const auto& variable : m_Variables) {
+            if (!IsInEntryPointInterface(variable) || IsBuiltIn(variable)) {
+                continue;
+            }
+
+            const bool read = variable.Storage == spv::StorageClassPushConstant
+                                  ? ReadPushConstant(variable, stage, pushConstants, variant)
+                                  : ReadVariable(variable, stage, lists, variant);
+            if (!read) {
+                return false;
+            }
+        }
+
+        USize count = resources.size() + pushConstants.size() + m_SpecializationConstants.size();
+        for (const auto& list : lists) {
+            count += list.size();
+        }
+
+        resources.reserve(count);
+
+        for (auto& list : lists) {
+            std::ranges::move(list, std::back_inserter(resources));
+        }
+
+        std::ranges::move(pushConstants, std::back_inserter(resources));
+
+        // Specialization constants are listed in declaration order, like variables
+        for (const UInt32 id : m_SpecializationConstants) {
+            if (m_Decorations[id].HasSpecId) {
+                ReadSpecializationConstant(id, stage, resources);
+            }
+        }
+
+        return true;
+    }
+
+    bool SpirvDecorationScanner::ReflectBlockLayouts(const std::vector<UInt32>& spirv,
+                                                     std::vector<ShaderBlockLayout>& layouts) {
+        if (!Scan(spirv)) {
+            return false;
+        }
+
+        // Uniform blocks come first, then storage blocks, then push constants, as their resources do
+        std::array<std::vector<ShaderBlockLayout>, 3> lists;
+
+        for (const auto& variable : m_Variables) {
+            if (!IsInEntryPointInterface(variable) || IsBuiltIn(variable)) {
+                continue;
+            }
+
+            const UInt32 baseType = GetBaseType(m_Types[variable.Type].Element);
+
+            ShaderBlockLayout layout{};
+            USize list;
+
+            if (variable.Storage == spv::StorageClassUniform && m_Decorations[baseType].Block) {
+                layout.Type = ShaderResourceType::BufferUniform;
+                layout.Name = GetBlockName(variable, false);
+                list = 0;
+            } else if ((variable.Storage == spv::StorageClassUniform && m_Decorations[baseType].BufferBlock) ||
+                       variable.Storage == spv::StorageClassStorageBuffer) {
+                layout.Type = ShaderResourceType::BufferStorage;
+                layout.Name = GetBlockName(variable, IsSsboInstanceNameSignificant());
+                list = 1;
+            } else if (variable.Storage == spv::StorageClassPushConstant) {
+                layout.Type = ShaderResourceType::PushConstant;
+                layout.Name = GetName(variable.Id);
+                list = 2;
+            } else {
+                continue;
+            }
+
+            layout.TypeName = GetName(baseType);
+            layout.Set = m_Decorations[variable.Id].DescriptorSet;
+            layout.Binding = m_Decorations[variable.Id].Binding;
+
+            if (!GetStructSize(baseType, 0, layout.Size) || !ReadBlockMembers(baseType, layout.Members)) {
+                return false;
+            }
+
+            lists[list].push_back(std::move(layout));
+        }
+
+        for (auto& list : lists) {
+            std::ranges::move(list, std::back_inserter(layouts));
+        }
+
+        return true;
+    }
+
+    bool SpirvDecorationScanner::Scan(const std::vector<UInt32>& spirv) {
+        if (spirv.size() < HeaderWordCount || spirv[0] != spv::MagicNumber) {
+            Log::Error("Invalid SPIR-V module header.");
+            return false;
+        }
+
+        m_Version = spirv[1];
+        m_SourceLanguage = spv::SourceLanguageUnknown;
+        m_SourceKnown = false;
+        m_Interface.clear();
+
+        const UInt32 bound = spirv[3];
+        if (bound > std::max(spirv.size(), MinIdBoundLimit)) {
+            Log::Error("Invalid SPIR-V id bound {} for a module of {} words.", bound, spirv.size());
+            return false;
+        }
+
+        m_Names.assign(bound, {});
+        m_Decorations.assign(bound, {});
+        m_Types.assign(bound, {});
+        m_Constants.assign(bound, {});
+
+        m_MemberDecorations.clear();
+        m_MemberNames.clear();
+        m_Variables.clear();
+        m_SpecializationConstants.clear();
+
+        bool entryPointFound = false;
+
+        // The types already used as the element or member of another type
+        std::vector<bool> referenced(bound, false);
+
+        for (USize offset = HeaderWordCount; offset < spirv.size();) {
+            const UInt32 wordCount = spirv[offset] >> spv::WordCountShift;
+            const auto op = static_cast<spv::Op>(spirv[offset] & spv::OpCodeMask);
+
+            if (wordCount == 0 || offset + wordCount > spirv.size()) {
+                Log::Error("Malformed SPIR-V instruction at word {}.", offset);
+                return false;
+            }
+
+            const UInt32* ops = spirv.data() + offset + 1;
+            const UInt32 length = wordCount - 1;
+
+            // Every operand an instruction is decoded from must be present, and every id it references in bound
+            bool valid = true;
+            const auto require = [&](const UInt32 count, const std::initializer_list<UInt32> ids = {}) {
+                valid = length >= count && std::ranges::all_of(ids, [bound](const UInt32 id) {
+                    return id < bound;
+                });
+                return valid;
+            };
+
+            // Types are declared once, and never after a type made of them, so they can't form cycles. Types the
+            // scanner doesn't track, such as acceleration structures, may still be elements.
+            const auto declare = [&](const std::span<const UInt32> elements = {}) {
+                for (const UInt32 id : elements) {
+                    referenced[id] = true;
+                }
+
+                valid = m_Types[ops[0]].Op == spv::OpNop && !referenced[ops[0]];
+                return valid;
+            };
+
+            switch (op) {
+            case spv::OpSource:
+                if (require(1)) {
+                    m_SourceKnown = true;
+                    m_SourceLanguage = ops[0];
+                }
+                break;
+            case spv::OpName:
+                if (require(2, {ops[0]})) {
+                    m_Names[ops[0]] = ReadString(ops + 1, length - 1);
+                }
+                break;
+            case spv::OpMemberName:
+                if (require(3, {ops[0]}) && ops[1] < MaxStructMembers) {
+                    auto& names = m_MemberNames[ops[0]];
+                    if (names.size() <= ops[1]) {
+                        names.resize(ops[1] + 1);
+                    }
+
+                    names[ops[1]] = ReadString(ops + 2, length - 2);
+                }
+                break;
+            case spv::OpEntryPoint:
+                if (!entryPointFound && require(3)) {
+                    // Only the first entry point is reflected, as SPIRV-Cross does by default
+                    const auto name = ReadString(ops + 2, length - 2);
+                    const UInt32 interfaceOffset = 2 + ToUInt32(name.size() / sizeof(UInt32)) + 1;
+
+                    m_Interface.assign(ops + std::min(interfaceOffset, length), ops + length);
+                    entryPointFound = true;
+                }
+                break;
+            case spv::OpDecorate:
+                if (require(2, {ops[0]})) {
+                    auto& decorations = m_Decorations[ops[0]];
+                    const UInt32 value = length > 2 ? ops[2] : 0;
+
+                    switch (static_cast<spv::Decoration>(ops[1])) {
+                    case spv::DecorationLocation:
+                        decorations.Location = value;
+                        break;
+                    case spv::DecorationBinding:
+                        decorations.Binding = value;
+                        break;
+                    case spv::DecorationDescriptorSet:
+                        decorations.DescriptorSet = value;
+                        break;
+                    case spv::DecorationInputAttachmentIndex:
+                        decorations.InputAttachmentIndex = value;
+                        break;
+                    case spv::DecorationSpecId:
+                        decorations.SpecId = value;
+                        decorations.HasSpecId = true;
+                        break;
+                    case spv::DecorationArrayStride:
+                        decorations.ArrayStride = value;
+                        decorations.HasArrayStride = true;
+                        break;
+                    case spv::DecorationBlock:
+                        decorations.Block = true;
+                        break;
+                    case spv::DecorationBufferBlock:
+                        decorations.BufferBlock = true;
+                        break;
+                    case spv::DecorationBuiltIn:
+                        decorations.BuiltIn = true;
+                        break;
+                    default:
+                        break;
+                    }
+                }
+                break;
+            case spv::OpMemberDecorate:
+                if (require(3, {ops[0]}) && ops[1] < MaxStructMembers) {
+                    auto& members = m_MemberDecorations[ops[0]];
+                    if (members.size() <= ops[1]) {
+                        members.resize(ops[1] + 1);
+                    }
+
+                    auto& decorations = members[ops[1]];
+                    const UInt32 value = length > 3 ? ops[3] : 0;
+
+                    switch (static_cast<spv::Decoration>(ops[2])) {
+                    case spv::DecorationOffset:
+                        decorations.Offset = value;
+                        decorations.HasOffset = true;
+                        break;
+                    case spv::DecorationMatrixStride:
+                        decorations.MatrixStride = value;
+                        decorations.HasMatrixStride = true;
+                        break;
+                    case spv::DecorationRowMajor:
+                        decorations.RowMajor = true;
+                        break;
+                    case spv::DecorationColMajor:
+                        decorations.ColMajor = true;
+                        break;
+                    case spv::DecorationBuiltIn:
+                        decorations.BuiltIn = true;
+                        break;
+                    default:
+                        break;
+                    }
+                }
+                break;
+            case spv::OpTypeVoid:
+            case spv::OpTypeBool:
+            case spv::OpTypeSampler:
+                if (require(1, {ops[0]}) && declare()) {
+                    m_Types[ops[0]].Op = op;
+                }
+                break;
+            case spv::OpTypeInt:
+            case spv::OpTypeFloat:
+                if (require(2, {ops[0]}) && declare()) {
+                    m_Types[ops[0]].Op = op;
+                    m_Types[ops[0]].Width = ops[1];
+                    m_Types[ops[0]].Signed = op == spv::OpTypeInt && length > 2 && ops[2] != 0;
+                }
+                break;
+            case spv::OpTypeVector:
+            case spv::OpTypeMatrix:
+                if (require(3, {ops[0], ops[1]}) && declare({ops + 1, 1})) {
+                    m_Types[ops[0]].Op = op;
+                    m_Types[ops[0]].Element = ops[1];
+                    m_Types[ops[0]].Count = ops[2];
+                }
+                break;
+            case spv::OpTypeImage:
+                if (require(7, {ops[0], ops[1]}) && declare({ops + 1, 1})) {
+                    m_Types[ops[0]].Op = op;
+                    m_Types[ops[0]].Element = ops[1];
+                    m_Types[ops[0]].Dim = static_cast<spv::Dim>(ops[2]);
+                    m_Types[ops[0]].Sampled = ops[6];
+                }
+                break;
+            case spv::OpTypeSampledImage:
+            case spv::OpTypeRuntimeArray:
+                if (require(2, {ops[0], ops[1]}) && declare({ops + 1, 1})) {
+                    m_Types[ops[0]].Op = op;
+                    m_Types[ops[0]].Element = ops[1];
+                }
+                break;
+            case spv::OpTypeArray:
+                if (require(3, {ops[0], ops[1], ops[2]}) && declare({ops + 1, 1})) {
+                    m_Types[ops[0]].Op = op;
+                    m_Types[ops[0]].Element = ops[1];
+                    m_Types[ops[0]].Count = ops[2];
+                }
+                break;
+            case spv::OpTypeStruct:
+                if (require(1, {ops[0]}) &&
+                    std::all_of(ops + 1, ops + length, [bound](const UInt32 id) { return id < bound; }) &&
+                    declare({ops + 1, length - 1})) {
+                    m_Types[ops[0]].Op = op;
+                    m_Types[ops[0]].Members.assign(ops + 1, ops + length);
+                }
+                break;
+            case spv::OpTypePointer:
+                // The pointee isn't referenced, it may be declared later through OpTypeForwardPointer
+                if (require(3, {ops[0], ops[2]}) && declare()) {
+                    m_Types[ops[0]].Op = op;
+                    m_Types[ops[0]].Storage = static_cast<spv::StorageClass>(ops[1]);
+                    m_Types[ops[0]].Element = ops[2];
+                }
+                break;
+            case spv::OpConstant:
+            case spv::OpSpecConstant:
+                if (require(3, {ops[0], ops[1]})) {
+                    // Wider constants keep their low-order word, as SPIRV-Cross evaluates them
+                    m_Constants[ops[1]] = {ops[0], ops[2], op == spv::OpSpecConstant, true};
+
+                    if (op == spv::OpSpecConstant) {
+                        m_SpecializationConstants.push_back(ops[1]);
+                    }
+                }
+                break;
+            case spv::OpConstantTrue:
+            case spv::OpConstantFalse:
+            case spv::OpSpecConstantTrue:
+            case spv::OpSpecConstantFalse:
+            case spv::OpSpecConstantComposite:
+                if (require(2, {ops[0], ops[1]})) {
+                    const bool value = op == spv::OpConstantTrue || op == spv::OpSpecConstantTrue;
+                    const bool specialization = op != spv::OpConstantTrue && op != spv::OpConstantFalse;
+
+                    m_Constants[ops[1]] = {ops[0], value ? 1U : 0U, specialization, true};
+
+                    if (specialization) {
+                        m_SpecializationConstants.push_back(ops[1]);
+                    }
+                }
+                break;
+            case spv::OpVariable:
+                if (require(3, {ops[0], ops[1]})) {
+                    const auto storage = static_cast<spv::StorageClass>(ops[2]);
+
+                    if (storage != spv::StorageClassFunction && m_Types[ops[0]].Op == spv::OpTypePointer) {
+                        m_Variables.push_back({ops[1], ops[0], storage});
+                    }
+                }
+                break;
+            case spv::OpFunction:
+                // Every declaration the reflection needs precedes the first function
+                return true;
+            default:
+                break;
+            }
+
+            if (!valid) {
+                Log::Error("Malformed SPIR-V instruction at word {}.", offset);
+                return false;
+            }
+
+            offset += wordCount;
+        }
+
+        return true;
+    }
+
+    bool SpirvDecorationScanner::ReadVariable(const Variable& variable, const VkShaderStageFlagBits stage,
+                                              ResourceLists& lists, const ShaderVariant& variant) const {
+        const UInt32 type = m_Types[variable.Type].Element;
+        const UInt32 baseType = GetBaseType(type);
+        const auto& base = m_Types[baseType];
+        const auto& decorations = m_Decorations[variable.Id];
+        const bool opaque = variable.Storage == spv::StorageClassUniformConstant;
+
+        ShaderResource shaderResource{};
+        shaderResource.Stages = stage;
+        shaderResource.Name = GetName(variable.Id);
+        shaderResource.ArraySize = GetArraySize(type);
+        shaderResource.Set = decorations.DescriptorSet;
+        shaderResource.Binding = decorations.Binding;
+
+        if (variable.Storage == spv::StorageClassInput || variable.Storage == spv::StorageClassOutput) {
+            shaderResource.Type = variable.Storage == spv::StorageClassInput
+                                      ? ShaderResourceType::Input
+                                      : ShaderResourceType::Output;
+            shaderResource.Set = 0;
+            shaderResource.Binding = 0;
+            shaderResource.Location = decorations.Location;
+            shaderResource.VecSize = 1;
+            shaderResource.Columns = 1;
+
+            if (base.Op == spv::OpTypeVector) {
+                shaderResource.VecSize = base.Count;
+            } else if (base.Op == spv::OpTypeMatrix) {
+                shaderResource.VecSize = m_Types[base.Element].Count;
+                shaderResource.Columns = base.Count;
+            }
+
+            if (m_Decorations[baseType].Block) {
+                shaderResource.Name = GetBlockName(variable, false);
+            }
+        } else if (opaque && base.Op == spv::OpTypeImage && base.Dim == spv::DimSubpassData) {
+            shaderResource.Type = ShaderResourceType::InputAttachment;
+            shaderResource.Stages = VK_SHADER_STAGE_FRAGMENT_BIT;
+            shaderResource.InputAttachmentIndex = decorations.InputAttachmentIndex;
+        } else if (variable.Storage == spv::StorageClassUniform && m_Decorations[baseType].Block) {
+            shaderResource.Type = ShaderResourceType::BufferUniform;
+            shaderResource.Name = GetBlockName(variable, false);
+        } else if ((variable.Storage == spv::StorageClassUniform && m_Decorations[baseType].BufferBlock) ||
+                   variable.Storage == spv::StorageClassStorageBuffer) {
+            shaderResource.Type = ShaderResourceType::BufferStorage;
+            shaderResource.Name = GetBlockName(variable, IsSsboInstanceNameSignificant());
+            shaderResource.Qualifiers |= ShaderResourceQualifier::NonReadable;
+            shaderResource.Qualifiers |= ShaderResourceQualifier::NonWritable;
+        } else if (opaque && base.Op == spv::OpTypeImage && base.Sampled == 2) {
+            shaderResource.Type = ShaderResourceType::ImageStorage;
+            shaderResource.Qualifiers |= ShaderResourceQualifier::NonReadable;
+            shaderResource.Qualifiers |= ShaderResourceQualifier::NonWritable;
+        } else if (opaque && base.Op == spv::OpTypeImage && base.Sampled == 1) {
+            shaderResource.Type = ShaderResourceType::Image;
+        } else if (opaque && base.Op == spv::OpTypeSampler) {
+            shaderResource.Type = ShaderResourceType::Sampler;
+        } else if (opaque && base.Op == spv::OpTypeSampledImage) {
+            shaderResource.Type = ShaderResourceType::ImageSampler;
+        } else {
+            // Not a resource type the reflection reports
+            return true;
+        }
+
+        if (shaderResource.Type == ShaderResourceType::BufferUniform ||
+            shaderResource.Type == ShaderResourceType::BufferStorage) {
+            USize runtimeArraySize{0};
+            if (variant.GetRuntimeArraySizes().contains(shaderResource.Name)) {
+                runtimeArraySize = variant.GetRuntimeArraySizes().at(shaderResource.Name);
+            }
+
+            if (!GetStructSize(baseType, runtimeArraySize, shaderResource.Size)) {
+                return false;
+            }
+        }
+
+        lists[static_cast<USize>(shaderResource.Type)].push_back(std::move(shaderResource));
+
+        return true;
+    }
+
+    bool SpirvDecorationScanner::ReadPushConstant(const Variable& variable, const VkShaderStageFlagBits stage,
+                                                  std::vector<ShaderResource>& resources,
+                                                  const ShaderVariant& variant) const {
+        const UInt32 baseType = GetBaseType(m_Types[variable.Type].Element);
+
+        UInt32 offset = std::numeric_limits<UInt32>::max();
+
+        for (UInt32 i = 0; i < m_Types[baseType].Members.size(); ++i) {
+            offset = std::min(offset, GetMemberDecorations(baseType, i).Offset);
+        }
+
+        ShaderResource shaderResource{};
+        shaderResource.Type = ShaderResourceType::PushConstant;
+        shaderResource.Stages = stage;
+        shaderResource.Name = GetName(variable.Id);
+        shaderResource.Offset = offset;
+
+        USize runtimeArraySize{0};
+        if (variant.GetRuntimeArraySizes().contains(shaderResource.Name)) {
+            runtimeArraySize = variant.GetRuntimeArraySizes().at(shaderResource.Name);
+        }
+
+        if (!GetStructSize(baseType, runtimeArraySize, shaderResource.Size)) {
+            return false;
+        }
+
+        shaderResource.Size -= shaderResource.Offset;
+
+        resources.push_back(std::move(shaderResource));
+
+        return true;
+    }
+
+    void SpirvDecorationScanner::ReadSpecializationConstant(const UInt32 id, const VkShaderStageFlagBits stage,
+                                                            std::vector<ShaderResource>& resources) const {
+        ShaderResource shaderResource{};
+        shaderResource.Type = ShaderResourceType::SpecializationConstant;
+        shaderResource.Stages = stage;
+        shaderResource.Name = GetName(id);
+        shaderResource.Offset = 0;
+        shaderResource.ConstantId = m_Decorations[id].SpecId;
+        shaderResource.Size = GetConstantSize(id);
+
+        resources.push_back(std::move(shaderResource));
+    }
+
+    bool SpirvDecorationScanner::ReadBlockMembers(const UInt32 type, std::vector<ShaderBlockMember>& members) const {
+        const auto& memberTypes = m_Types[type].Members;
+        members.resize(memberTypes.size());
+
+        for (UInt32 i = 0; i < memberTypes.size(); ++i) {
+            const auto& decorations = GetMemberDecorations(type, i);
+            auto& member = members[i];
+
+            member.Name = GetMemberName(type, i);
+            member.Offset = decorations.Offset;
+
+            if (!GetMemberSize(type, i, member.Size)) {
+                return false;
+            }
+
+            // Unlike GetBaseType(), the dimensions are listed outermost first, each with the stride of its array
+            UInt32 memberType = memberTypes[i];
+            for (USize depth = 0;
+                 depth < m_Types.size() &&
+                 (m_Types[memberType].Op == spv::OpTypeArray || m_Types[memberType].Op == spv::OpTypeRuntimeArray);
+                 ++depth) {
+                const auto& array = m_Types[memberType];
+
+                member.ArrayDimensions.push_back(array.Op == spv::OpTypeRuntimeArray ? 0
+                                                                                     : GetConstantValue(array.Count));
+                member.ArrayStrides.push_back(m_Decorations[memberType].ArrayStride);
+
+                memberType = array.Element;
+            }
+
+            const auto& base = m_Types[memberType];
+
+            member.BaseType = GetScalarType(memberType);
+            member.VecSize = 1;
+            member.Columns = 1;
+
+            if (base.Op == spv::OpTypeVector) {
+                member.VecSize = base.Count;
+            } else if (base.Op == spv::OpTypeMatrix) {
+                member.VecSize = m_Types[base.Element].Count;
+                member.Columns = base.Count;
+                member.MatrixStride = decorations.MatrixStride;
+                member.RowMajor = decorations.RowMajor;
+            } else if (base.Op == spv::OpTypeStruct) {
+                member.TypeName = GetName(memberType);
+
+                if (!ReadBlockMembers(memberType, member.Members)) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool SpirvDecorationScanner::IsInEntryPointInterface(const Variable& variable) const {
+        // Before SPIR-V 1.4, only the stage inputs and outputs are listed in the entry point interface
+        if (m_Version < 0x10400 && variable.Storage != spv::StorageClassInput &&
+            variable.Storage != spv::StorageClassOutput) {
+            return true;
+        }
+
+        return std::ranges::find(m_Interface, variable.Id) != m_Interface.end();
+    }
+
+    bool SpirvDecorationScanner::IsBuiltIn(const Variable& variable) const {
+        if (m_Decorations[variable.Id].BuiltIn) {
+            return true;
+        }
+
+        const auto it = m_MemberDecorations.find(GetBaseType(m_Types[variable.Type].Element));
+        if (it == m_MemberDecorations.end()) {
+            return false;
+        }
+
+        return std::ranges::any_of(it->second, [](const MemberDecorations& member) {
+            return member.BuiltIn;
+        });
+    }
+
+    bool SpirvDecorationScanner::IsSsboInstanceNameSignificant() const {
+        // HLSL reuses block types across UAVs, leaving the instance name as the only meaningful one
+        if (m_SourceKnown) {
+            return m_SourceLanguage == spv::SourceLanguageHLSL;
+        }
+
+        std::unordered_set<UInt32> blockTypes;
+
+        for (const auto& variable : m_Variables) {
+            const UInt32 baseType = GetBaseType(m_Types[variable.Type].Element);
+
+            const bool storage = variable.Storage == spv::StorageClassStorageBuffer ||
+                                 (variable.Storage == spv::StorageClassUniform &&
+                                  m_Decorations[baseType].BufferBlock);
+
+            if (storage && !blockTypes.insert(baseType).second) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    std::string SpirvDecorationScanner::GetBlockName(const Variable& variable, const bool preferInstanceName) const {
+        const UInt32 baseType = GetBaseType(m_Types[variable.Type].Element);
+
+        if (!preferInstanceName && !m_Names[baseType].empty()) {
+            return m_Names[baseType];
+        }
+
+        if (!m_Names[variable.Id].empty()) {
+            return m_Names[variable.Id];
+        }
+
+        return preferInstanceName ? fmt::format("_{}", variable.Id) : fmt::format("_{}_{}", baseType, variable.Id);
+    }
+
+    const std::string& SpirvDecorationScanner::GetName(const UInt32 id) const {
+        return m_Names[id];
+    }
+
+    const std::string& SpirvDecorationScanner::GetMemberName(const UInt32 type, const UInt32 index) const {
+        static const std::string None;
+
+        const auto it = m_MemberNames.find(type);
+        if (it == m_MemberNames.end() || index >= it->second.size()) {
+            return None;
+        }
+
+        return it->second[index];
+    }
+
+    ShaderBaseType SpirvDecorationScanner::GetScalarType(UInt32 type) const {
+        while (m_Types[type].Op == spv::OpTypeVector || m_Types[type].Op == spv::OpTypeMatrix) {
+            type = m_Types[type].Element;
+        }
+
+        const auto& scalar = m_Types[type];
+
+        switch (scalar.Op) {
+        case spv::OpTypeBool:
+            return ShaderBaseType::Bool;
+        case spv::OpTypeInt:
+            if (scalar.Width == 32) {
+                return scalar.Signed ? ShaderBaseType::Int : ShaderBaseType::UInt;
+            }
+
+            if (scalar.Width == 64) {
+                return scalar.Signed ? ShaderBaseType::Int64 : ShaderBaseType::UInt64;
+            }
+
+            return ShaderBaseType::Unknown;
+        case spv::OpTypeFloat:
+            switch (scalar.Width) {
+            case 16:
+                return ShaderBaseType::Half;
+            case 32:
+                return ShaderBaseType::Float;
+            case 64:
+                return ShaderBaseType::Double;
+            default:
+                return ShaderBaseType::Unknown;
+            }
+        case spv::OpTypeStruct:
+            return ShaderBaseType::Struct;
+        default:
+            return ShaderBaseType::Unknown;
+        }
+    }
+
+    UInt32 SpirvDecorationScanner::GetBaseType(UInt32 type, std::vector<ArrayDimension>* dimensions) const {
+        // Scan() rejects cyclic types, the depth is bounded all the same so a cycle can't hang the reflection
+        for (USize depth = 0;
+             depth < m_Types.size() &&
+             (m_Types[type].Op == spv::OpTypeArray || m_Types[type].Op == spv::OpTypeRuntimeArray);
+             ++depth) {
+            if (dimensions) {
+                const auto& array = m_Types[type];
+                if (array.Op == spv::OpTypeRuntimeArray) {
+                    dimensions->push_back({0, true});
+                } else if (const auto& length = m_Constants[array.Count]; length.Defined && !length.Specialization) {
+                    dimensions->push_back({length.Value, true});
+                } else {
+                    dimensions->push_back({array.Count, false});
+                }
+            }
+
+            type = m_Types[type].Element;
+        }
+
+        if (dimensions) {
+            std::ranges::reverse(*dimensions);
+        }
+
+        return type;
+    }
+
+    UInt32 SpirvDecorationScanner::GetArraySize(const UInt32 type) const {
+        std::vector<ArrayDimension> dimensions;
+        static_cast<void>(GetBaseType(type, &dimensions));
+
+        return dimensions.empty() ? 1 : dimensions.front().Length;
+    }
+
+    bool SpirvDecorationScanner::GetStructSize(const UInt32 type, const USize runtimeArraySize, UInt32& size) const {
+        const auto& members = m_Types[type].Members;
+        if (m_Types[type].Op != spv::OpTypeStruct || members.empty()) {
+            Log::Error("Declared struct in block cannot be empty.");
+            return false;
+        }
+
+        // Offsets can be declared out of order, the size is deduced from the member with the highest offset
+        UInt32 memberIndex = 0;
+        UInt32 highestOffset = 0;
+
+        for (UInt32 i = 0; i < members.size(); ++i) {
+            const auto& decorations = GetMemberDecorations(type, i);
+            if (!decorations.HasOffset) {
+                Log::Error("Struct member does not have Offset set.");
+                return false;
+            }
+
+            if (decorations.Offset > highestOffset) {
+                highestOffset = decorations.Offset;
+                memberIndex = i;
+            }
+        }
+
+        UInt32 memberSize;
+        if (!GetMemberSize(type, memberIndex, memberSize)) {
+            return false;
+        }
+
+        size = highestOffset + memberSize;
+
+        // A runtime array as the last member is sized by the variant
+        std::vector<ArrayDimension> dimensions;
+        static_cast<void>(GetBaseType(members.back(), &dimensions));
+
+        if (!dimensions.empty() && dimensions.front().Literal && dimensions.front().Length == 0) {
+            UInt32 stride;
+            if (!GetMemberArrayStride(type, ToUInt32(members.size() - 1), stride)) {
+                return false;
+            }
+
+            size += ToUInt32(runtimeArraySize * stride);
+        }
+
+        return true;
+    }
+
+    bool SpirvDecorationScanner::GetMemberSize(const UInt32 type, const UInt32 index, UInt32& size) const {
+        const UInt32 memberType = m_Types[type].Members[index];
+        const auto& member = m_Types[memberType];
+
+        switch (member.Op) {
+        case spv::OpTypeArray:
+        case spv::OpTypeRuntimeArray: {
+            std::vector<ArrayDimension> dimensions;
+            static_cast<void>(GetBaseType(memberType, &dimensions));
+
+            const auto& outermost = dimensions.back();
+
+            UInt32 stride;
+            if (!GetMemberArrayStride(type, index, stride)) {
+                return false;
+            }
+
+            size = stride * (outermost.Literal ? outermost.Length : GetConstantValue(outermost.Length));
+            return true;
+        }
+        case spv::OpTypeStruct:
+            return GetStructSize(memberType, 0, size);
+        case spv::OpTypePointer:
+            // Physical storage buffer addresses
+            size = 8;
+            return true;
+        case spv::OpTypeInt:
+        case spv::OpTypeFloat:
+            size = member.Width / 8;
+            return true;
+        case spv::OpTypeVector:
+            size = m_Types[member.Element].Width / 8 * member.Count;
+            return true;
+        case spv::OpTypeMatrix: {
+            const auto& decorations = GetMemberDecorations(type, index);
+            if (!decorations.HasMatrixStride) {
+                Log::Error("Struct member does not have MatrixStride set.");
+                return false;
+            }
+
+            if (decorations.RowMajor) {
+                size = decorations.MatrixStride * m_Types[member.Element].Count;
+            } else if (decorations.ColMajor) {
+                size = decorations.MatrixStride * member.Count;
+            } else {
+                Log::Error("Either row-major or column-major must be declared for matrices.");
+                return false;
+            }
+
+            return true;
+        }
+        default:
+            Log::Error("Querying size for object with opaque size.");
+            return false;
+        }
+    }
+
+    bool SpirvDecorationScanner::GetMemberArrayStride(const UInt32 type, const UInt32 index, UInt32& stride) const {
+        // ArrayStride is part of the array type, not of the member decorations
+        const auto& decorations = m_Decorations[m_Types[type].Members[index]];
+        if (!decorations.HasArrayStride) {
+            Log::Error("Struct member does not have ArrayStride set.");
+            return false;
+        }
+
+        stride = decorations.ArrayStride;
+
+        return true;
+    }
+
+    const SpirvDecorationScanner::MemberDecorations& SpirvDecorationScanner::GetMemberDecorations(
+        const UInt32 type, const UInt32 index) const {
+        static const MemberDecorations None{};
+
+        const auto it = m_MemberDecorations.find(type);
+        if (it == m_MemberDecorations.end() || index >= it->second.size()) {
+            return None;
+        }
+
+        return it->second[index];
+    }
+
+    UInt32 SpirvDecorationScanner::GetConstantValue(const UInt32 id) const {
+        return id < m_Constants.size() ? m_Constants[id].Value : 0;
+    }
+
+    UInt32 SpirvDecorationScanner::GetConstantSize(const UInt32 id) const {
+        UInt32 type = m_Constants[id].Type;
+        while (m_Types[type].Op == spv::OpTypeVector || m_Types[type].Op == spv::OpTypeMatrix) {
+            type = m_Types[type].Element;
+        }
+
+        switch (m_Types[type].Op) {
+        case spv::OpTypeBool:
+            return 4;
+        case spv::OpTypeInt:
+        case spv::OpTypeFloat:
+            return m_Types[type].Width == 32 || m_Types[type].Width == 64 ? m_Types[type].Width / 8 : 0;
+        default:
+            return 0;
+        }
+    }
+}
@@ -0,0 +1,164 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#include <VulkanTests/Renderer/SpirvOptimizer.hpp>
+
+#include <VulkanTests/Core/Logger.hpp>
+
+#include <glslang/SPIRV/SPVRemapper.h>
+
+#include <spirv-tools/optimizer.hpp>
+
+#include <cstring>
+
+namespace VkTests {
+    namespace {
+        constexpr USize SpirvHeaderSize = 5;
+
+        // The remapper reports errors through a process-wide handler, remappings run concurrently on many threads
+        thread_local std::string* t_RemapInfoLog = nullptr;
+        thread_local bool t_RemapFailed = false;
+
+        void SetMessageConsumer(spvtools::Optimizer& optimizer, std::string& infoLog) {
+            optimizer.SetMessageConsumer([&infoLog](const spv_message_level_t level, const char*,
+                                                    const spv_position_t& position, const char* message) {
+                if (level <= SPV_MSG_WARNING) {
+                    infoLog += fmt::format("spirv-opt: {} (SPIR-V word {})\n", message, position.index);
+                }
+            });
+        }
+    }
+
+    bool SpirvOptimizer::IsEnabled(const ShaderVariant& shaderVariant) {
+        return shaderVariant.GetOptimizationLevel() != ShaderOptimizationLevel::None ||
+               shaderVariant.GetStripDebugInfo() || shaderVariant.GetRemap() ||
+               shaderVariant.GetFreezeSpecializationConstants();
+    }
+
+    bool SpirvOptimizer::Optimize(const spv_target_env targetEnvironment, const ShaderVariant& shaderVariant,
+                                  std::vector<UInt32>& spirv, std::string& infoLog, ShaderCompileStats* stats) {
+        if (!IsEnabled(shaderVariant)) {
+            return true;
+        }
+
+        spvtools::Optimizer optimizer{targetEnvironment};
+        SetMessageConsumer(optimizer, infoLog);
+
+        if (shaderVariant.GetFreezeSpecializationConstants()) {
+            std::unordered_map<UInt32, std::vector<UInt32>> defaultValues;
+            for (const auto& [constantId, value] : shaderVariant.GetSpecializationConstants()) {
+                auto& words = defaultValues[constantId];
+                words.resize(value.Size / sizeof(UInt32));
+                std::memcpy(words.data(), &value.Bits, value.Size);
+            }
+
+            // The values become the defaults, then every specialization constant is turned into a regular constant
+            // and the expressions using them are folded
+            optimizer.RegisterPass(spvtools::CreateSetSpecConstantDefaultValuePass(defaultValues));
+            optimizer.RegisterPass(spvtools::CreateFreezeSpecConstantValuePass());
+            optimizer.RegisterPass(spvtools::CreateFoldSpecConstantOpAndCompositePass());
+            optimizer.RegisterPass(spvtools::CreateUnifyConstantPass());
+
+            // Removes the branches the folded conditions disable, even without an optimization level
+            optimizer.RegisterPass(spvtools::CreateDeadBranchElimPass());
+            optimizer.RegisterPass(spvtools::CreateAggressiveDCEPass());
+            optimizer.RegisterPass(spvtools::CreateEliminateDeadConstantPass());
+            optimizer.RegisterPass(spvtools::CreateCFGCleanupPass());
+        }
+
+        switch (shaderVariant.GetOptimizationLevel()) {
+        case ShaderOptimizationLevel::Size:
+            optimizer.RegisterSizePasses();
+            break;
+
+        case ShaderOptimizationLevel::Performance:
+            optimizer.RegisterPerformancePasses();
+            break;
+
+        case ShaderOptimizationLevel::None:
+            break;
+        }
+
+        if (shaderVariant.GetStripDebugInfo()) {
+            optimizer.RegisterPass(spvtools::CreateStripDebugInfoPass());
+        }
+
+        std::vector<UInt32> optimized;
+        if (!optimizer.Run(spirv.data(), spirv.size(), &optimized)) {
+            infoLog += "SPIR-V optimization failed.\n";
+            return false;
+        }
+
+        if (shaderVariant.GetRemap()) {
+            // The remapper exits the process on errors by default
+            static const bool errorHandlerRegistered = [] {
+                spv::spirvbin_t::registerErrorHandler([](const std::string& message) {
+                    t_RemapFailed = true;
+                    if (t_RemapInfoLog) {
+                        *t_RemapInfoLog += fmt::format("SPIR-V remapping failed: {}\n", message);
+                    }
+                });
+                return true;
+            }();
+            (void)errorHandlerRegistered;
+
+            t_RemapInfoLog = &infoLog;
+            t_RemapFailed = false;
+
+            spv::spirvbin_t remapper;
+            remapper.remap(optimized, spv::spirvbin_t::MAP_ALL | spv::spirvbin_t::DCE_ALL);
+
+            t_RemapInfoLog = nullptr;
+
+            // The remapped module may be truncated, it must not reach the cache
+            if (t_RemapFailed) {
+                return false;
+            }
+        }
+
+        // Only counted for the statistics, the module is walked twice
+        if (stats) {
+            stats->InstructionCountBefore = CountInstructions(spirv);
+            stats->InstructionCountAfter = CountInstructions(optimized);
+        }
+
+        spirv = std::move(optimized);
+
+        return true;
+    }
+
+    bool SpirvOptimizer::Legalize(const spv_target_env targetEnvironment, std::vector<UInt32>& spirv,
+                                  std::string& infoLog) {
+        spvtools::Optimizer optimizer{targetEnvironment};
+        SetMessageConsumer(optimizer, infoLog);
+        optimizer.RegisterLegalizationPasses();
+
+        std::vector<UInt32> legalized;
+        if (!optimizer.Run(spirv.data(), spirv.size(), &legalized)) {
+            infoLog += "SPIR-V legalization failed.\n";
+            return false;
+        }
+
+        spirv = std::move(legalized);
+
+        return true;
+    }
+
+    USize SpirvOptimizer::CountInstructions(const std::vector<UInt32>& spirv) {
+        USize count = 0;
+
+        // The upper 16 bits of the first word of an instruction hold its word count
+        for (USize i = SpirvHeaderSize; i < spirv.size();) {
+            const UInt32 wordCount = spirv[i] >> 16;
+            if (wordCount == 0) {
+                break;
+            }
+
+            i += wordCount;
+            ++count;
+        }
+
+        return count;
+    }
+}
@@ -4,14 +4,20 @@
 
 #include <VulkanTests/Renderer/SpirvReflection.hpp>
 
+#include <VulkanTests/Renderer/SpirvDecorationScanner.hpp>
+
 #include <VulkanTests/Utils/Helpers.hpp>
 
+#include <cstring>
+
 namespace VkTests {
     namespace {
         template <ShaderResourceType T>
-        void ReadShaderResource(const spirv_cross::Compiler& compiler, const VkShaderStageFlagBits stage,
-                                std::vector<ShaderResource>& resources, const ShaderVariant& variant) {
+        void ReadShaderResource(const spirv_cross::Compiler& compiler, const spirv_cross::ShaderResources& allResources,
+                                const VkShaderStageFlagBits stage, std::vector<ShaderResource>& resources,
+                                const ShaderVariant& variant) {
             VK_TESTS_UNUSED(compiler);
+            VK_TESTS_UNUSED(allResources);
             VK_TESTS_UNUSED(stage);
             VK_TESTS_UNUSED(resources);
             VK_TESTS_UNUSED(variant);
@@ -105,14 +111,12 @@ namespace VkTests {
 
         void ReadResourceArraySize(const spirv_cross::Compiler& compiler, const spirv_cross::Resource& resource,
                                    ShaderResource& shaderResource, const ShaderVariant& variant) {
-            const auto& spirvType = compiler.get_type_from_variable(resource.id);
+            VK_TESTS_UNUSED(variant);
 
-            USize arraySize = 0;
-            if (variant.GetRuntimeArraySizes().contains(resource.name)) {
-                arraySize = variant.GetRuntimeArraySizes().at(resource.name);
-            }
+            const auto& spirvType = compiler.get_type_from_variable(resource.id);
 
-            shaderResource.ArraySize = ToUInt32(compiler.get_declared_struct_size_runtime_array(spirvType, arraySize));
+            // The innermost dimension, or the id of the specialization constant sizing it
+            shaderResource.ArraySize = spirvType.array.empty() ? 1 : spirvType.array[0];
         }
 
         void ReadResourceSize(const spirv_cross::Compiler& compiler, const spirv_cross::Resource& resource,
@@ -152,10 +156,11 @@ namespace VkTests {
 
         template <>
         void ReadShaderResource<ShaderResourceType::Input>(const spirv_cross::Compiler& compiler,
+                                                           const spirv_cross::ShaderResources& allResources,
                                                            const VkShaderStageFlagBits stage,
                                                            std::vector<ShaderResource>& resources,
                                                            const ShaderVariant& variant) {
-            for (auto& resource : compiler.get_shader_resources().stage_inputs) {
+            for (auto& resource : allResources.stage_inputs) {
                 ShaderResource shaderResource{};
                 shaderResource.Type = ShaderResourceType::Input;
                 shaderResource.Stages = stage;
@@ -171,12 +176,13 @@ namespace VkTests {
 
         template <>
         void ReadShaderResource<ShaderResourceType::InputAttachment>(const spirv_cross::Compiler& compiler,
+                                                                     const spirv_cross::ShaderResources& allResources,
                                                                      const VkShaderStageFlagBits stage,
                                                                      std::vector<ShaderResource>& resources,
                                                                      const ShaderVariant& variant) {
             VK_TESTS_UNUSED(stage);
 
-            for (auto& subpassInput : compiler.get_shader_resources().subpass_inputs) {
+            for (auto& subpassInput : allResources.subpass_inputs) {
                 ShaderResource shaderResource{};
                 shaderResource.Type = ShaderResourceType::InputAttachment;
                 shaderResource.Stages = VK_SHADER_STAGE_FRAGMENT_BIT;
@@ -194,10 +200,11 @@ namespace VkTests {
 
         template <>
         void ReadShaderResource<ShaderResourceType::Output>(const spirv_cross::Compiler& compiler,
+                                                            const spirv_cross::ShaderResources& allResources,
                                                             const VkShaderStageFlagBits stage,
                                                             std::vector<ShaderResource>& resources,
                                                             const ShaderVariant& variant) {
-            for (auto& output : compiler.get_shader_resources().stage_outputs) {
+            for (auto& output : allResources.stage_outputs) {
                 ShaderResource shaderResource{};
                 shaderResource.Type = ShaderResourceType::Output;
                 shaderResource.Stages = stage;
@@ -213,10 +220,11 @@ namespace VkTests {
 
         template <>
         void ReadShaderResource<ShaderResourceType::Image>(const spirv_cross::Compiler& compiler,
+                                                           const spirv_cross::ShaderResources& allResources,
                                                            const VkShaderStageFlagBits stage,
                                                            std::vector<ShaderResource>& resources,
                                                            const ShaderVariant& variant) {
-            for (auto& image : compiler.get_shader_resources().separate_images) {
+            for (auto& image : allResources.separate_images) {
                 ShaderResource shaderResource{};
                 shaderResource.Type = ShaderResourceType::Image;
                 shaderResource.Stages = stage;
@@ -232,10 +240,11 @@ namespace VkTests {
 
         template <>
         void ReadShaderResource<ShaderResourceType::ImageSampler>(const spirv_cross::Compiler& compiler,
+                                                                  const spirv_cross::ShaderResources& allResources,
                                                                   const VkShaderStageFlagBits stage,
                                                                   std::vector<ShaderResource>& resources,
                                                                   const ShaderVariant& variant) {
-            for (auto& image : compiler.get_shader_resources().sampled_images) {
+            for (auto& image : allResources.sampled_images) {
                 ShaderResource shaderResource{};
                 shaderResource.Type = ShaderResourceType::ImageSampler;
                 shaderResource.Stages = stage;
@@ -251,10 +260,11 @@ namespace VkTests {
 
         template <>
         void ReadShaderResource<ShaderResourceType::ImageStorage>(const spirv_cross::Compiler& compiler,
+                                                                  const spirv_cross::ShaderResources& allResources,
                                                                   const VkShaderStageFlagBits stage,
                                                                   std::vector<ShaderResource>& resources,
                                                                   const ShaderVariant& variant) {
-            for (auto& image : compiler.get_shader_resources().storage_images) {
+            for (auto& image : allResources.storage_images) {
                 ShaderResource shaderResource{};
                 shaderResource.Type = ShaderResourceType::ImageStorage;
                 shaderResource.Stages = stage;
@@ -272,10 +282,11 @@ namespace VkTests {
 
         template <>
         void ReadShaderResource<ShaderResourceType::Sampler>(const spirv_cross::Compiler& compiler,
+                                                             const spirv_cross::ShaderResources& allResources,
                                                              const VkShaderStageFlagBits stage,
                                                              std::vector<ShaderResource>& resources,
                                                              const ShaderVariant& variant) {
-            for (auto& sampler : compiler.get_shader_resources().separate_samplers) {
+            for (auto& sampler : allResources.separate_samplers) {
                 ShaderResource shaderResource{};
                 shaderResource.Type = ShaderResourceType::Sampler;
                 shaderResource.Stages = stage;
@@ -291,10 +302,11 @@ namespace VkTests {
 
         template <>
         void ReadShaderResource<ShaderResourceType::BufferUniform>(const spirv_cross::Compiler& compiler,
+                                                                   const spirv_cross::ShaderResources& allResources,
                                                                    const VkShaderStageFlagBits stage,
                                                                    std::vector<ShaderResource>& resources,
                                                                    const ShaderVariant& variant) {
-            for (auto& buffer : compiler.get_shader_resources().uniform_buffers) {
+            for (auto& buffer : allResources.uniform_buffers) {
                 ShaderResource shaderResource{};
                 shaderResource.Type = ShaderResourceType::BufferUniform;
                 shaderResource.Stages = stage;
@@ -311,10 +323,11 @@ namespace VkTests {
 
         template <>
         void ReadShaderResource<ShaderResourceType::BufferStorage>(const spirv_cross::Compiler& compiler,
+                                                                   const spirv_cross::ShaderResources& allResources,
                                                                    const VkShaderStageFlagBits stage,
                                                                    std::vector<ShaderResource>& resources,
                                                                    const ShaderVariant& variant) {
-            for (auto& buffer : compiler.get_shader_resources().storage_buffers) {
+            for (auto& buffer : allResources.storage_buffers) {
                 ShaderResource shaderResource{};
                 shaderResource.Type = ShaderResourceType::BufferStorage;
                 shaderResource.Stages = stage;
@@ -330,40 +343,206 @@ namespace VkTests {
                 resources.push_back(shaderResource);
             }
         }
+
+        ShaderBaseType GetBaseType(const spirv_cross::SPIRType& type) {
+            switch (type.basetype) {
+            case spirv_cross::SPIRType::BaseType::Boolean:
+                return ShaderBaseType::Bool;
+            case spirv_cross::SPIRType::BaseType::Int:
+                return ShaderBaseType::Int;
+            case spirv_cross::SPIRType::BaseType::UInt:
+                return ShaderBaseType::UInt;
+            case spirv_cross::SPIRType::BaseType::Int64:
+                return ShaderBaseType::Int64;
+            case spirv_cross::SPIRType::BaseType::UInt64:
+                return ShaderBaseType::UInt64;
+            case spirv_cross::SPIRType::BaseType::Half:
+                return ShaderBaseType::Half;
+            case spirv_cross::SPIRType::BaseType::Float:
+                return ShaderBaseType::Float;
+            case spirv_cross::SPIRType::BaseType::Double:
+                return ShaderBaseType::Double;
+            case spirv_cross::SPIRType::BaseType::Struct:
+                return ShaderBaseType::Struct;
+            default:
+                return ShaderBaseType::Unknown;
+            }
+        }
+
+        void ReadBlockMembers(const spirv_cross::Compiler& compiler, const spirv_cross::SPIRType& structType,
+                              std::vector<ShaderBlockMember>& members) {
+            members.resize(structType.member_types.size());
+
+            for (UInt32 i = 0; i < structType.member_types.size(); ++i) {
+                const auto& type = compiler.get_type(structType.member_types[i]);
+                auto& member = members[i];
+
+                member.Name = compiler.get_member_name(structType.self, i);
+                member.BaseType = GetBaseType(type);
+                member.Offset = compiler.get_member_decoration(structType.self, i, spv::DecorationOffset);
+                member.Size = ToUInt32(compiler.get_declared_struct_member_size(structType, i));
+                member.VecSize = type.vecsize;
+                member.Columns = type.columns;
+
+                // SPIRV-Cross lists the dimensions innermost first, the element type of each array is its parent type
+                UInt32 arrayTypeId = structType.member_types[i];
+                for (USize dimension = type.array.size(); dimension-- > 0;) {
+                    member.ArrayDimensions.push_back(type.array_size_literal[dimension]
+                                                         ? type.array[dimension]
+                                                         : compiler.get_constant(type.array[dimension]).scalar());
+                    member.ArrayStrides.push_back(compiler.get_decoration(arrayTypeId, spv::DecorationArrayStride));
+
+                    arrayTypeId = compiler.get_type(arrayTypeId).parent_type;
+                }
+
+                if (type.columns > 1) {
+                    member.MatrixStride = compiler.get_member_decoration(structType.self, i,
+                                                                         spv::DecorationMatrixStride);
+                    member.RowMajor = compiler.has_member_decoration(structType.self, i, spv::DecorationRowMajor);
+                }
+
+                if (type.basetype == spirv_cross::SPIRType::BaseType::Struct) {
+                    member.TypeName = compiler.get_name(type.self);
+                    ReadBlockMembers(compiler, type, member.Members);
+                }
+            }
+        }
+
+        void ReadBlockLayouts(const spirv_cross::Compiler& compiler,
+                              const spirv_cross::SmallVector<spirv_cross::Resource>& resources,
+                              const ShaderResourceType type, std::vector<ShaderBlockLayout>& layouts) {
+            for (const auto& resource : resources) {
+                const auto& spirvType = compiler.get_type(resource.base_type_id);
+
+                ShaderBlockLayout layout{};
+                layout.Type = type;
+                layout.Name = resource.name;
+                layout.TypeName = compiler.get_name(resource.base_type_id);
+                layout.Set = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
+                layout.Binding = compiler.get_decoration(resource.id, spv::DecorationBinding);
+                layout.Size = ToUInt32(compiler.get_declared_struct_size(spirvType));
+
+                ReadBlockMembers(compiler, spirvType, layout.Members);
+
+                layouts.push_back(std::move(layout));
+            }
+        }
+
+        template <typename T>
+        void WriteValue(std::vector<UInt8>& data, const T& value) {
+            static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+            const auto* bytes = reinterpret_cast<const UInt8*>(&value);
+            data.insert(data.end(), bytes, bytes + sizeof(T));
+        }
+
+        void WriteString(std::vector<UInt8>& data, const std::string& str) {
+            WriteValue(data, static_cast<UInt32>(str.size()));
+            data.insert(data.end(), str.begin(), str.end());
+        }
+
+        // The size of a resource with an empty name, as written by SerializeResources()
+        constexpr USize MinimumSerializedResourceSize =
+            sizeof(ShaderResource::Stages) + sizeof(ShaderResource::Type) + sizeof(ShaderResource::Mode) +
+            sizeof(ShaderResource::Set) + sizeof(ShaderResource::Binding) + sizeof(ShaderResource::Location) +
+            sizeof(ShaderResource::InputAttachmentIndex) + sizeof(ShaderResource::VecSize) +
+            sizeof(ShaderResource::Columns) + sizeof(ShaderResource::ArraySize) + sizeof(ShaderResource::Offset) +
+            sizeof(ShaderResource::Size) + sizeof(ShaderResource::ConstantId) + sizeof(ShaderResource::Qualifiers) +
+            sizeof(UInt32);
+
+        // Reads values back from a byte range, failing instead of reading past its end
+        class Reader {
+        public:
+            Reader(const UInt8* data, const USize size) : m_Data{data}, m_Size{size} {
+            }
+
+            template <typename T>
+            bool Read(T& value) {
+                static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+                if (m_Offset + sizeof(T) > m_Size) {
+                    return false;
+                }
+
+                std::memcpy(&value, m_Data + m_Offset, sizeof(T));
+                m_Offset += sizeof(T);
+
+                return true;
+            }
+
+            bool ReadString(std::string& str) {
+                UInt32 size;
+                if (!Read(size) || m_Offset + size > m_Size) {
+                    return false;
+                }
+
+                str.assign(reinterpret_cast<const char*>(m_Data + m_Offset), size);
+                m_Offset += size;
+
+                return true;
+            }
+
+            [[nodiscard]] USize GetRemaining() const {
+                return m_Size - m_Offset;
+            }
+
+        private:
+            const UInt8* m_Data;
+            USize m_Size;
+            USize m_Offset{0};
+        };
     }
 
+    std::atomic<SpirvReflectionBackend> SpirvReflection::m_SBackend{SpirvReflectionBackend::DecorationScanner};
+
     bool SpirvReflection::ReflectShaderResources(const VkShaderStageFlagBits stage, const std::vector<UInt32>& spirv,
                                                  std::vector<ShaderResource>& resources, const ShaderVariant& variant) {
-        spirv_cross::CompilerGLSL compiler{spirv};
+        if (GetBackend() == SpirvReflectionBackend::DecorationScanner) {
+            SpirvDecorationScanner scanner;
+            return scanner.ReflectShaderResources(stage, spirv, resources, variant);
+        }
+
+        // Reflection only needs the parsed module, not a cross-compiler to a high-level language
+        const spirv_cross::Compiler compiler{spirv};
 
-        auto opts = compiler.get_common_options();
-        opts.enable_420pack_extension = true;
+        // Enumerating the resources walks every variable of the module, it is done once for all resource types
+        const auto allResources = compiler.get_shader_resources();
+        const auto specializationConstants = compiler.get_specialization_constants();
 
-        compiler.set_common_options(opts);
+        resources.reserve(resources.size() + allResources.stage_inputs.size() +
+                          allResources.subpass_inputs.size() + allResources.stage_outputs.size() +
+                          allResources.separate_images.size() + allResources.sampled_images.size() +
+                          allResources.storage_images.size() + allResources.separate_samplers.size() +
+                          allResources.uniform_buffers.size() + allResources.storage_buffers.size() +
+                          allResources.push_constant_buffers.size() + specializationConstants.size());
 
-        ParseShaderResources(compiler, stage, resources, variant);
-        ParsePushConstants(compiler, stage, resources, variant);
-        ParseSpecializationConstants(compiler, stage, resources, variant);
+        ParseShaderResources(compiler, allResources, stage, resources, variant);
+        ParsePushConstants(compiler, allResources, stage, resources, variant);
+        ParseSpecializationConstants(compiler, specializationConstants, stage, resources, variant);
 
         return true;
     }
 
-    void SpirvReflection::ParseShaderResources(const spirv_cross::Compiler& compiler, const VkShaderStageFlagBits stage,
+    void SpirvReflection::ParseShaderResources(const spirv_cross::Compiler& compiler,
+                                               const spirv_cross::ShaderResources& allResources,
+                                               const VkShaderStageFlagBits stage,
                                                std::vector<ShaderResource>& resources, const ShaderVariant& variant) {
-        ReadShaderResource<ShaderResourceType::Input>(compiler, stage, resources, variant);
-        ReadShaderResource<ShaderResourceType::InputAttachment>(compiler, stage, resources, variant);
-        ReadShaderResource<ShaderResourceType::Output>(compiler, stage, resources, variant);
-        ReadShaderResource<ShaderResourceType::Image>(compiler, stage, resources, variant);
-        ReadShaderResource<ShaderResourceType::ImageSampler>(compiler, stage, resources, variant);
-        ReadShaderResource<ShaderResourceType::ImageStorage>(compiler, stage, resources, variant);
-        ReadShaderResource<ShaderResourceType::Sampler>(compiler, stage, resources, variant);
-        ReadShaderResource<ShaderResourceType::BufferUniform>(compiler, stage, resources, variant);
-        ReadShaderResource<ShaderResourceType::BufferStorage>(compiler, stage, resources, variant);
+        ReadShaderResource<ShaderResourceType::Input>(compiler, allResources, stage, resources, variant);
+        ReadShaderResource<ShaderResourceType::InputAttachment>(compiler, allResources, stage, resources, variant);
+        ReadShaderResource<ShaderResourceType::Output>(compiler, allResources, stage, resources, variant);
+        ReadShaderResource<ShaderResourceType::Image>(compiler, allResources, stage, resources, variant);
+        ReadShaderResource<ShaderResourceType::ImageSampler>(compiler, allResources, stage, resources, variant);
+        ReadShaderResource<ShaderResourceType::ImageStorage>(compiler, allResources, stage, resources, variant);
+        ReadShaderResource<ShaderResourceType::Sampler>(compiler, allResources, stage, resources, variant);
+        ReadShaderResource<ShaderResourceType::BufferUniform>(compiler, allResources, stage, resources, variant);
+        ReadShaderResource<ShaderResourceType::BufferStorage>(compiler, allResources, stage, resources, variant);
     }
 
-    void SpirvReflection::ParsePushConstants(const spirv_cross::Compiler& compiler, const VkShaderStageFlagBits stage,
+    void SpirvReflection::ParsePushConstants(const spirv_cross::Compiler& compiler,
+                                             const spirv_cross::ShaderResources& allResources,
+                                             const VkShaderStageFlagBits stage,
                                              std::vector<ShaderResource>& resources, const ShaderVariant& variant) {
-        for (auto& resource : compiler.get_shader_resources().push_constant_buffers) {
+        for (auto& resource : allResources.push_constant_buffers) {
             const auto& spirvType = compiler.get_type_from_variable(resource.id);
 
             UInt32 offset = std::numeric_limits<UInt32>::max();
@@ -388,11 +567,11 @@ namespace VkTests {
         }
     }
 
-    void SpirvReflection::ParseSpecializationConstants(const spirv_cross::Compiler& compiler,
-                                                       const VkShaderStageFlagBits stage,
-                                                       std::vector<ShaderResource>& resources,
-                                                       const ShaderVariant& variant) {
-        for (auto& constant : compiler.get_specialization_constants()) {
+    void SpirvReflection::ParseSpecializationConstants(
+        const spirv_cross::Compiler& compiler,
+        const spirv_cross::SmallVector<spirv_cross::SpecializationConstant>& specializationConstants,
+        const VkShaderStageFlagBits stage, std::vector<ShaderResource>& resources, const ShaderVariant& variant) {
+        for (auto& constant : specializationConstants) {
             auto& spirvValue = compiler.get_constant(constant.id);
 
             ShaderResource shaderResource{};
@@ -408,4 +587,84 @@ namespace VkTests {
         }
     }
 
+    bool SpirvReflection::ReflectBlockLayouts(const std::vector<UInt32>& spirv,
+                                              std::vector<ShaderBlockLayout>& layouts) {
+        if (GetBackend() == SpirvReflectionBackend::DecorationScanner) {
+            SpirvDecorationScanner scanner;
+            return scanner.ReflectBlockLayouts(spirv, layouts);
+        }
+
+        // The layouts are gathered apart, so a malformed module leaves the output untouched
+        std::vector<ShaderBlockLayout> blockLayouts;
+
+        try {
+            const spirv_cross::Compiler compiler{spirv};
+            const auto allResources = compiler.get_shader_resources();
+
+            ReadBlockLayouts(compiler, allResources.uniform_buffers, ShaderResourceType::BufferUniform, blockLayouts);
+            ReadBlockLayouts(compiler, allResources.storage_buffers, ShaderResourceType::BufferStorage, blockLayouts);
+            ReadBlockLayouts(compiler, allResources.push_constant_buffers, ShaderResourceType::PushConstant,
+                             blockLayouts);
+        } catch (const std::exception& e) {
+            Log::Error("Failed to reflect block layouts: {}", e.what());
+            return false;
+        }
+
+        std::ranges::move(blockLayouts, std::back_inserter(layouts));
+
+        return true;
+    }
+
+    std::vector<UInt8> SpirvReflection::SerializeResources(const std::vector<ShaderResource>& resources) {
+        std::vector<UInt8> data;
+
+        WriteValue(data, static_cast<UInt32>(resources.size()));
+
+        for (const auto& resource : resources) {
+            WriteValue(data, resource.Stages);
+            WriteValue(data, resource.Type);
+            WriteValue(data, resource.Mode);
+            WriteValue(data, resource.Set);
+            WriteValue(data, resource.Binding);
+            WriteValue(data, resource.Location);
+            WriteValue(data, resource.InputAttachmentIndex);
+            WriteValue(data, resource.VecSize);
+            WriteValue(data, resource.Columns);
+            WriteValue(data, resource.ArraySize);
+            WriteValue(data, resource.Offset);
+            WriteValue(data, resource.Size);
+            WriteValue(data, resource.ConstantId);
+            WriteValue(data, resource.Qualifiers);
+            WriteString(data, resource.Name);
+        }
+
+        return data;
+    }
+
+    bool SpirvReflection::DeserializeResources(const UInt8* data, const USize size,
+                                               std::vector<ShaderResource>& resources) {
+        Reader reader{data, size};
+
+        // A corrupted count mustn't allocate more resources than the data can hold
+        UInt32 count;
+        if (!reader.Read(count) || count > reader.GetRemaining() / MinimumSerializedResourceSize) {
+            return false;
+        }
+
+        resources.resize(count);
+
+        for (auto& resource : resources) {
+            if (!reader.Read(resource.Stages) || !reader.Read(resource.Type) || !reader.Read(resource.Mode) ||
+                !reader.Read(resource.Set) || !reader.Read(resource.Binding) || !reader.Read(resource.Location) ||
+                !reader.Read(resource.InputAttachmentIndex) || !reader.Read(resource.VecSize) ||
+                !reader.Read(resource.Columns) || !reader.Read(resource.ArraySize) ||
+                !reader.Read(resource.Offset) || !reader.Read(resource.Size) ||
+                !reader.Read(resource.ConstantId) || !reader.Read(resource.Qualifiers) ||
+                !reader.ReadString(resource.Name)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
 }
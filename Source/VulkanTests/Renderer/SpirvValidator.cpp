@@ -0,0 +1,109 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+#include <VulkanTests/Renderer/SpirvValidator.hpp>
+
+#include <VulkanTests/Core/Logger.hpp>
+
+#include <spirv-tools/libspirv.hpp>
+
+#include <spirv_cross/spirv.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace VkTests {
+    namespace {
+        constexpr USize HeaderWordCount = 5;
+
+        ShaderDiagnosticSeverity FindSeverity(const spv_message_level_t level) {
+            switch (level) {
+            case SPV_MSG_FATAL:
+            case SPV_MSG_INTERNAL_ERROR:
+            case SPV_MSG_ERROR:
+                return ShaderDiagnosticSeverity::Error;
+
+            case SPV_MSG_WARNING:
+                return ShaderDiagnosticSeverity::Warning;
+
+            default:
+                return ShaderDiagnosticSeverity::Info;
+            }
+        }
+
+        // Locates the instruction starting at a word of the module with the OpLine preceding it in its block. Only
+        // modules compiled with debug information have OpLine instructions, the location stays unknown otherwise.
+        void FindSourceLocation(const std::vector<UInt32>& spirv, const USize wordIndex, ShaderDiagnostic& diagnostic) {
+            std::unordered_map<UInt32, std::string_view> files;
+            const UInt32* line = nullptr;
+
+            for (USize offset = HeaderWordCount; offset < std::min(wordIndex, spirv.size());) {
+                const UInt32 wordCount = spirv[offset] >> spv::WordCountShift;
+                if (wordCount == 0 || wordCount > spirv.size() - offset) {
+                    return;
+                }
+
+                const UInt32* ops = spirv.data() + offset + 1;
+
+                switch (static_cast<spv::Op>(spirv[offset] & spv::OpCodeMask)) {
+                case spv::OpString:
+                    if (wordCount > 2) {
+                        const auto* chars = reinterpret_cast<const char*>(ops + 1);
+                        files[ops[0]] = {chars, strnlen(chars, (wordCount - 2) * sizeof(UInt32))};
+                    }
+                    break;
+
+                case spv::OpLine:
+                    line = wordCount >= 4 ? ops : nullptr;
+                    break;
+
+                // An OpLine only applies up to the end of its block
+                case spv::OpNoLine:
+                case spv::OpLabel:
+                case spv::OpFunctionEnd:
+                    line = nullptr;
+                    break;
+
+                default:
+                    break;
+                }
+
+                offset += wordCount;
+            }
+
+            if (!line) {
+                return;
+            }
+
+            if (const auto it = files.find(line[0]); it != files.end()) {
+                diagnostic.File = it->second;
+            }
+            diagnostic.Line = line[1];
+        }
+    }
+
+    bool SpirvValidator::Validate(const spv_target_env targetEnvironment, const std::vector<UInt32>& spirv,
+                                  std::string& infoLog, std::vector<ShaderDiagnostic>& diagnostics) {
+        spvtools::SpirvTools tools{targetEnvironment};
+        tools.SetMessageConsumer([&](const spv_message_level_t level, const char*,
+                                     const spv_position_t& position, const char* message) {
+            // The position of a binary has no line, only the word of the instruction
+            ShaderDiagnostic diagnostic{};
+            diagnostic.WordIndex = static_cast<USize>(position.index);
+            FindSourceLocation(spirv, diagnostic.WordIndex, diagnostic);
+            diagnostic.Severity = FindSeverity(level);
+            diagnostic.Message = message;
+
+            infoLog += fmt::format("spirv-val: {} (SPIR-V word {})\n", message, position.index);
+            diagnostics.push_back(std::move(diagnostic));
+        });
+
+        if (!tools.Validate(spirv.data(), spirv.size(), spvtools::ValidatorOptions{})) {
+            infoLog += "SPIR-V validation failed.\n";
+            return false;
+        }
+
+        return true;
+    }
+}
@@ -4,12 +4,17 @@
 
 #include <VulkanTests/Renderer/VkCommon.hpp>
 
+#include <VulkanTests/Renderer/Error.hpp>
+#include <VulkanTests/Renderer/GlslCompiler.hpp>
+#include <VulkanTests/Renderer/ShaderIncludeResolver.hpp>
 #include <VulkanTests/Renderer/Strings.hpp>
 
 #include <VulkanTests/Core/Logger.hpp>
 
 #include <VulkanTests/Filesystem/Assets.hpp>
 
+#include <cstring>
+
 std::ostream& operator<<(std::ostream& os, const VkResult result) {
 #define WRITE_VK_ENUM(r) \
     case VK_##r:  \
@@ -50,44 +55,6 @@ std::ostream& operator<<(std::ostream& os, const VkResult result) {
 }
 
 namespace VkTests {
-	namespace {
-		VkShaderStageFlagBits FindShaderStage(const std::string& ext) {
-			switch (ext) {
-			case "vert":
-				return VK_SHADER_STAGE_VERTEX_BIT;
-			case "frag":
-				return VK_SHADER_STAGE_FRAGMENT_BIT;
-			case "comp":
-				return VK_SHADER_STAGE_COMPUTE_BIT;
-			case "geom":
-				return VK_SHADER_STAGE_GEOMETRY_BIT;
-			case "tesc":
-				return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
-			case "tese":
-				return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
-			case "rgen":
-				return VK_SHADER_STAGE_RAYGEN_BIT_KHR;
-			case "rahit":
-				return VK_SHADER_STAGE_ANY_HIT_BIT_KHR;
-			case "rchit":
-				return VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR;
-			case "rmiss":
-				return VK_SHADER_STAGE_MISS_BIT_KHR;
-			case "rint":
-				return VK_SHADER_STAGE_INTERSECTION_BIT_KHR;
-			case "rcall":
-				return VK_SHADER_STAGE_CALLABLE_BIT_KHR;
-			case "mesh":
-				return VK_SHADER_STAGE_MESH_BIT_EXT;
-			case "task":
-				return VK_SHADER_STAGE_TASK_BIT_EXT;
-			default:
-				Log::Fatal({0x02, 0x00}, "File extensions {} does not have a Vulkan shader stage flag.");
-				return VK_SHADER_STAGE_FLAG_BITS_MAX_ENUM;
-			}
-		}
-	}
-
 	VkFormat GetSuitableDepthFormat(const VkPhysicalDevice physicalDevice, const bool depthOnly,
 	                                const std::vector<VkFormat>& depthFormatPriorityList) {
 		VkFormat depthFormat{VK_FORMAT_UNDEFINED};
@@ -150,8 +117,78 @@ namespace VkTests {
 	}
 
 
+	std::optional<VkShaderStageFlagBits> FindShaderStage(const std::filesystem::path& path) {
+		static const std::unordered_map<std::string, VkShaderStageFlagBits> stages = {
+			{".vert", VK_SHADER_STAGE_VERTEX_BIT},
+			{".tesc", VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT},
+			{".tese", VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT},
+			{".geom", VK_SHADER_STAGE_GEOMETRY_BIT},
+			{".frag", VK_SHADER_STAGE_FRAGMENT_BIT},
+			{".comp", VK_SHADER_STAGE_COMPUTE_BIT},
+			{".rgen", VK_SHADER_STAGE_RAYGEN_BIT_KHR},
+			{".rahit", VK_SHADER_STAGE_ANY_HIT_BIT_KHR},
+			{".rchit", VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR},
+			{".rmiss", VK_SHADER_STAGE_MISS_BIT_KHR},
+			{".rint", VK_SHADER_STAGE_INTERSECTION_BIT_KHR},
+			{".rcall", VK_SHADER_STAGE_CALLABLE_BIT_KHR},
+			{".mesh", VK_SHADER_STAGE_MESH_BIT_EXT},
+			{".task", VK_SHADER_STAGE_TASK_BIT_EXT}
+		};
+
+		const std::filesystem::path extension = path.extension();
+		const auto it = stages.find(extension == ".hlsl" ? path.stem().extension().string() : extension.string());
+		if (it == stages.end()) {
+			return std::nullopt;
+		}
+
+		return it->second;
+	}
+
 	VkShaderModule LoadShader(const std::string& filename, VkDevice device, VkShaderStageFlagBits stage,
 	                          ShaderSourceLanguage srcLanguage) {
+		if (const auto extension = std::filesystem::path{filename}.extension(); extension == ".spv") {
+			srcLanguage = ShaderSourceLanguage::Spv;
+		} else if (extension == ".hlsl") {
+			srcLanguage = ShaderSourceLanguage::Hlsl;
+		}
+
+		std::vector<UInt32> spirv;
+
+		if (srcLanguage == ShaderSourceLanguage::Spv) {
+			const std::vector<UInt8> binary = Filesystem::ReadShaderBinary(filename);
+			if (binary.empty() || binary.size() % sizeof(UInt32) != 0) {
+				throw VulkanException{VK_ERROR_INITIALIZATION_FAILED, "Invalid SPIR-V file " + filename};
+			}
+
+			spirv.resize(binary.size() / sizeof(UInt32));
+			std::memcpy(spirv.data(), binary.data(), binary.size());
+		} else {
+			ShaderSource source{filename};
+			source.SetLanguage(srcLanguage == ShaderSourceLanguage::Hlsl ? ShadingLanguage::Hlsl
+			                                                              : ShadingLanguage::Glsl);
+
+			// Compiled like any shader module, so the shader cache applies
+			ExpandedShaderSource expandedSource;
+			std::string infoLog;
+			std::vector<ShaderDiagnostic> diagnostics;
+			if (source.GetSource().empty() ||
+			    !ShaderIncludeResolver::Get().Expand(source, expandedSource, infoLog) ||
+			    !GlslCompiler::CompileToSpirv(stage, expandedSource, "main", ShaderVariant{}, spirv, infoLog,
+			                                  diagnostics)) {
+				Log::Error("Shader compilation failed for shader \"{}\"", filename);
+				Log::Error("{}", infoLog);
+				throw VulkanException{VK_ERROR_INITIALIZATION_FAILED, "Shader compilation failed"};
+			}
+		}
+
+		VkShaderModuleCreateInfo createInfo{VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
+		createInfo.codeSize = spirv.size() * sizeof(UInt32);
+		createInfo.pCode = spirv.data();
+
+		VkShaderModule shaderModule;
+		VK_CHECK(vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule));
+
+		return shaderModule;
 	}
 
 	VkAccessFlags GetAccessFlags(const VkImageLayout layout) {
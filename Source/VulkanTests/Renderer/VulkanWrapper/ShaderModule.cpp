@@ -8,10 +8,18 @@
 #include <VulkanTests/Renderer/Strings.hpp>
 #include <VulkanTests/Renderer/Error.hpp>
 #include <VulkanTests/Renderer/GlslCompiler.hpp>
+#include <VulkanTests/Renderer/GlslangSession.hpp>
+#include <VulkanTests/Renderer/ShaderArchive.hpp>
+#include <VulkanTests/Renderer/ShaderCache.hpp>
+#include <VulkanTests/Renderer/ShaderIncludeResolver.hpp>
 #include <VulkanTests/Renderer/SpirvReflection.hpp>
 
+#include <VulkanTests/Core/Profiling.hpp>
+
 #include <VulkanTests/Filesystem/Assets.hpp>
 
+#include <algorithm>
+
 namespace VkTests {
     ShaderVariant::ShaderVariant(std::string&& preamble, std::vector<std::string>&& processes)
         : m_Preamble(std::move(preamble)), m_Processes(std::move(processes)) {
@@ -49,125 +57,296 @@ namespace VkTests {
     }
 
     void ShaderVariant::AddRuntimeArraySize(const std::string& runtimeArrayName, USize size) {
-        if (m_RuntimeArraySizes.contains(runtimeArrayName)) {
-            m_RuntimeArraySizes.insert({runtimeArrayName, size});
-            return;
-        }
-
         m_RuntimeArraySizes[runtimeArrayName] = size;
+
+        UpdateId();
+    }
+
+    void ShaderVariant::SetRuntimeArraySizes(const std::unordered_map<std::string, USize>& sizes) {
+        m_RuntimeArraySizes = sizes;
+
+        UpdateId();
+    }
+
+    void ShaderVariant::SetOptimizationLevel(const ShaderOptimizationLevel level) {
+        m_OptimizationLevel = level;
+
+        UpdateId();
+    }
+
+    void ShaderVariant::SetStripDebugInfo(const bool strip) {
+        m_StripDebugInfo = strip;
+
+        UpdateId();
+    }
+
+    void ShaderVariant::SetRemap(const bool remap) {
+        m_Remap = remap;
+
+        UpdateId();
+    }
+
+    void ShaderVariant::SetFreezeSpecializationConstants(const bool freeze) {
+        m_FreezeSpecializationConstants = freeze;
+
+        UpdateId();
     }
 
     void ShaderVariant::Clear() {
         m_Preamble.clear();
+        m_Processes.clear();
+        m_RuntimeArraySizes.clear();
+        m_OptimizationLevel = ShaderOptimizationLevel::None;
+        m_StripDebugInfo = false;
+        m_Remap = false;
+        m_SpecializationConstants.clear();
+        m_FreezeSpecializationConstants = false;
+
+        UpdateId();
     }
 
     void ShaderVariant::UpdateId() {
-        constexpr std::hash<std::string> hasher;
-        m_Id = hasher(m_Preamble);
-    }
-
-    ShaderSource::ShaderSource(const std::string& filename) : m_Filename(filename),
-                                                              m_Source(Filesystem::ReadShader(filename)) {
-        constexpr std::hash<std::string> hasher{};
-        m_Id = hasher(std::string{m_Source.cbegin(), m_Source.cend()});
-    }
-
-    /**
-     * @brief Pre-compiles project shader files to include header code.
-     * @param source The shader file in a string
-     * @return An array containing the final shader.
-     */
-    inline std::vector<std::string> PrecompileShader(const std::string& source) {
-        std::vector<std::string> finalFile;
-
-        for (const auto lines = Split(source, '\n');
-             auto& line : lines) {
-            if (line.starts_with("#include \"")) {
-                // Include paths are relative to the base shader directory
-                std::string includePath = line.substr(10);
-                const USize lastQuote = includePath.find('\"');
-                if (!includePath.empty() && lastQuote != std::string::npos) {
-                    includePath = includePath.substr(0, lastQuote);
-                }
+        StreamHasher hasher;
+        hasher.Update(m_Preamble);
+        hasher.UpdateValue(m_OptimizationLevel);
+        hasher.UpdateValue(m_StripDebugInfo);
+        hasher.UpdateValue(m_Remap);
+        hasher.UpdateValue(m_FreezeSpecializationConstants);
+
+        // The sizes change the reflected resources, the map's iteration order is unspecified so they are sorted
+        std::vector<std::pair<std::string_view, USize>> runtimeArraySizes{
+            m_RuntimeArraySizes.begin(), m_RuntimeArraySizes.end()
+        };
+        std::ranges::sort(runtimeArraySizes);
+
+        for (const auto& [name, size] : runtimeArraySizes) {
+            hasher.Update(name);
+            hasher.UpdateValue(static_cast<UInt64>(size));
+        }
 
-                auto includeFile = PrecompileShader(Filesystem::ReadShader(includePath));
-                for (auto& includeFileLine : includeFile) {
-                    finalFile.push_back(includeFileLine);
-                }
-            } else {
-                finalFile.push_back(line);
+        // Without freezing, the values only matter when creating pipelines, variants differing by them alone
+        // share the same SPIR-V
+        if (m_FreezeSpecializationConstants) {
+            for (const auto& [constantId, value] : m_SpecializationConstants) {
+                hasher.UpdateValue(constantId);
+                hasher.UpdateValue(value.Bits);
+                hasher.UpdateValue(value.Size);
             }
         }
 
-        return finalFile;
+        m_Id = hasher.Digest();
+    }
+
+    ShaderSource::ShaderSource(const std::string& filename) : m_Filename(filename) {
+        if (std::filesystem::path{filename}.extension() == ".hlsl") {
+            m_Language = ShadingLanguage::Hlsl;
+        }
+
+        // Shipping builds load their shaders from the mounted archive, the sources may not be there at all
+        if (Filesystem::IsFile(Filesystem::Paths::Get(Filesystem::Paths::Type::Shaders, filename))) {
+            m_Source = Filesystem::ReadShader(filename);
+        } else if (!ShaderArchive::GetMounted()) {
+            Log::Error("Shader source \"{}\" doesn't exist and no shader archive is mounted.", filename);
+        }
+
+        UpdateId();
     }
 
-    inline std::vector<UInt8> ConvertToBytes(std::vector<std::string>& lines) {
-        std::vector<UInt8> bytes;
+    void ShaderSource::UpdateId() {
+        StreamHasher hasher;
 
-        for (auto& line : lines) {
-            line += '\n';
-            std::vector<UInt8> lineBytes(line.begin(), line.end());
-            bytes.insert(bytes.end(), lineBytes.begin(), lineBytes.end());
+        // Without a source, the shader can only come from the archive and is told apart from others by its name
+        if (m_Source.empty()) {
+            hasher.Update(std::string_view{"filename"});
+            hasher.Update(m_Filename);
+        } else {
+            hasher.Update(m_Source);
         }
 
-        return bytes;
+        // The same text compiles to different modules as GLSL and as HLSL
+        hasher.UpdateValue(m_Language);
+
+        m_Id = hasher.Digest();
     }
 
     ShaderModule::ShaderModule(Device& device, const VkShaderStageFlagBits stage, const ShaderSource& glslSource,
                                const std::string& entryPoint, const ShaderVariant& shaderVariant)
         : m_Device(device), m_Stage(stage), m_EntryPoint(entryPoint) {
-        m_DebugName = fmt::format("{} [variant: {:X}] [entrypoint {}]", glslSource.GetFilename(), shaderVariant.GetId(),
-                                  entryPoint);
+        m_DebugName = fmt::format("{} [variant: {}] [entrypoint {}]", glslSource.GetFilename(),
+                                  shaderVariant.GetId().ToString(), entryPoint);
 
         // Compiling from GLSL source requires the entry point
         if (entryPoint.empty()) {
             throw VulkanException{VK_ERROR_INITIALIZATION_FAILED, "Shader entry point is empty"};
         }
 
-        const auto& source = glslSource.GetSource();
-
-        // Check if application is passing in GLSL source code to compile to SPIR-V
-        if (source.empty()) {
-            throw VulkanException{VK_ERROR_INITIALIZATION_FAILED, "Shader source is empty"};
+        // Keep glslang initialized while modules compiled from source are alive, an archive doesn't need it
+        if (!glslSource.GetSource().empty()) {
+            m_GlslangSession = GlslangSession::Acquire();
         }
 
-        // Precompile the shader source into the final SPIR-V bytecode
+        auto result = Compile(stage, glslSource, entryPoint, shaderVariant);
 
-        if (auto glslFinalSource = PrecompileShader(source);
-            !GlslCompiler::CompileToSpirv(stage, ConvertToBytes(glslFinalSource), entryPoint, shaderVariant, m_Spirv,
-                                          m_InfoLog)) {
+        if (!result.Success) {
+            m_InfoLog = std::move(result.InfoLog);
+            m_Diagnostics = std::move(result.Diagnostics);
             Log::Error("Shader compilation failed for shader \"{}\"", glslSource.GetFilename());
             Log::Error("{}", m_InfoLog);
             throw VulkanException{VK_ERROR_INITIALIZATION_FAILED, "Shader compilation failed"};
         }
 
-        // Reflect all shader resources
-        if (SpirvReflection spirvReflection;
-            !spirvReflection.ReflectShaderResources(stage, m_Spirv, m_Resources, shaderVariant)) {
-            throw VulkanException{VK_ERROR_INITIALIZATION_FAILED, "Shader reflection failed"};
-        }
+        Reload(std::move(result));
+    }
 
-        // Generate a unique id, determined by source and variant
-        constexpr std::hash<std::string> hasher{};
-        m_Id = hasher(std::string{reinterpret_cast<const char*>(m_Spirv.data()),
-            reinterpret_cast<const char*>(m_Spirv.data() + m_Spirv.size())});
+    std::future<ShaderModule> ShaderModule::CreateAsync(Device& device, ThreadPool& threadPool,
+                                                        const VkShaderStageFlagBits stage,
+                                                        const ShaderSource& glslSource,
+                                                        const std::string& entryPoint,
+                                                        const ShaderVariant& shaderVariant) {
+        // The compilation inputs are captured by value, the caller's objects may be gone by the time the task runs.
+        // Only the device is captured by reference, the caller keeps it alive until the future is ready.
+        return threadPool.Submit([&device, stage, glslSource, entryPoint, shaderVariant] {
+            return ShaderModule{device, stage, glslSource, entryPoint, shaderVariant};
+        });
     }
 
+    ShaderCompileResult ShaderModule::Compile(const VkShaderStageFlagBits stage, const ShaderSource& glslSource,
+                                              const std::string& entryPoint, const ShaderVariant& shaderVariant) {
+        PROFILE_FUNCTION();
+
+        ShaderCompileResult result{};
+
+        auto& stats = result.Stats;
+        stats.Filename = glslSource.GetFilename();
+        stats.EntryPoint = entryPoint;
+        stats.Stage = stage;
+        stats.VariantId = shaderVariant.GetId();
+
+        // Records the statistics on every path, once the total time and the outcome are known
+        const auto startTime = std::chrono::steady_clock::now();
+        const auto record = [&result, &startTime] {
+            result.Stats.TotalTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - startTime);
+            result.Stats.OutputSize = result.Spirv.size() * sizeof(UInt32);
+            result.Stats.Success = result.Success;
+            ShaderStats::Record(result.Stats);
+        };
+
+        if (entryPoint.empty()) {
+            result.InfoLog = "Shader entry point is empty";
+            record();
+            return result;
+        }
+
+        const auto& source = glslSource.GetSource();
+
+        // Baked shaders are loaded as is, without compiling nor reflecting them. They are only used when the source
+        // isn't on disk: a source that is, possibly edited since baking or being hot reloaded, is always compiled.
+        if (source.empty()) {
+            const auto archive = ShaderArchive::GetMounted();
+
+            if (archive && archive->Find(ShaderArchive::ComputeKey(stage, glslSource.GetFilename(),
+                                                                   glslSource.GetLanguage(), entryPoint,
+                                                                   shaderVariant), result)) {
+                result.Success = true;
+                stats.CacheHit = true;
+                stats.ReflectionCacheHit = true;
+                record();
+                return result;
+            }
+
+            result.InfoLog = archive ? fmt::format("Shader \"{}\" is neither on disk nor in the mounted archive",
+                                                   glslSource.GetFilename())
+                                     : "Shader source is empty";
+            record();
+            return result;
+        }
 
-    ShaderModule::ShaderModule(ShaderModule&& other) :
+        // Expand the includes of the shader source
+        ExpandedShaderSource glslFinalSource;
+        bool expanded;
+        {
+            PROFILE_SCOPE("Shader include expansion");
+            ShaderStatsTimer timer{&stats.IncludeExpansionTime};
+            expanded = ShaderIncludeResolver::Get().Expand(glslSource, glslFinalSource, result.InfoLog);
+        }
+
+        if (!expanded) {
+            record();
+            return result;
+        }
+
+        // Compile the final shader source into SPIR-V bytecode
+        if (!GlslCompiler::CompileToSpirv(stage, glslFinalSource, entryPoint, shaderVariant, result.Spirv,
+                                          result.InfoLog, result.Diagnostics, &stats)) {
+            record();
+            return result;
+        }
+
+        // Reflect all shader resources, unless the reflection of this exact module is cached
+        {
+            PROFILE_SCOPE("Shader reflection");
+            ShaderStatsTimer timer{&stats.ReflectionTime};
+
+            const Hash128 reflectionKey = ShaderCache::ComputeReflectionKey(stage, result.Spirv, shaderVariant);
+            stats.ReflectionCacheHit = ShaderCache::LoadReflection(reflectionKey, result.Resources);
+
+            if (!stats.ReflectionCacheHit) {
+                if (SpirvReflection spirvReflection;
+                    !spirvReflection.ReflectShaderResources(stage, result.Spirv, result.Resources, shaderVariant)) {
+                    result.InfoLog += "Shader reflection failed\n";
+                    record();
+                    return result;
+                }
+
+                ShaderCache::StoreReflection(reflectionKey, result.Resources);
+            }
+        }
+
+        result.Success = true;
+
+        record();
+
+        return result;
+    }
+
+    ShaderModule::ShaderModule(ShaderModule&& other) noexcept :
         m_Device{other.m_Device},
+        m_GlslangSession{std::move(other.m_GlslangSession)},
         m_Id{other.m_Id},
         m_Stage{other.m_Stage},
         m_EntryPoint{std::move(other.m_EntryPoint)},
         m_DebugName{std::move(other.m_DebugName)},
         m_Spirv{std::move(other.m_Spirv)},
         m_Resources{std::move(other.m_Resources)},
-        m_InfoLog{std::move(other.m_InfoLog)} {
+        m_InfoLog{std::move(other.m_InfoLog)},
+        m_Diagnostics{std::move(other.m_Diagnostics)},
+        m_ResourceModes{std::move(other.m_ResourceModes)} {
         other.m_Stage = {};
     }
 
+    void ShaderModule::Reload(ShaderCompileResult&& result) {
+        m_Spirv = std::move(result.Spirv);
+        m_Resources = std::move(result.Resources);
+        m_InfoLog = std::move(result.InfoLog);
+        m_Diagnostics = std::move(result.Diagnostics);
+
+        // Generate a unique id, determined by source and variant
+        m_Id = ComputeHash128(std::span{m_Spirv});
+
+        // The resources were reflected again, with their default modes
+        for (const auto& [resourceName, mode] : m_ResourceModes) {
+            ApplyResourceMode(resourceName, mode);
+        }
+    }
+
     void ShaderModule::SetResourceMode(const std::string& resourceName, const ShaderResourceMode& mode) {
+        m_ResourceModes[resourceName] = mode;
+
+        ApplyResourceMode(resourceName, mode);
+    }
+
+    void ShaderModule::ApplyResourceMode(const std::string& resourceName, const ShaderResourceMode mode) {
         const auto it = std::ranges::find_if(m_Resources, [&resourceName](const ShaderResource& resource) {
             return resource.Name == resourceName;
         });
@@ -0,0 +1,204 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+// Hermetic tests of the filesystem and of the shader pipeline running on it. Every file lives in a
+// MemoryFilesystem set as the filesystem instance, nothing is read from or written to the disk.
+//
+// Usage: MemoryFilesystemTests
+//
+// Returns 0 if every test passed, 1 otherwise.
+
+#include <VulkanTests/Platform/EntryPoint.hpp>
+
+#include <VulkanTests/Filesystem/Filesystem.hpp>
+#include <VulkanTests/Filesystem/MemoryFilesystem.hpp>
+#include <VulkanTests/Filesystem/VirtualFilesystem.hpp>
+
+#include <VulkanTests/Renderer/GlslangSession.hpp>
+#include <VulkanTests/Renderer/ShaderCache.hpp>
+#include <VulkanTests/Renderer/ShaderIncludeResolver.hpp>
+
+#include <algorithm>
+#include <array>
+
+#define VK_TESTS_CHECK(condition)                                                           \
+    do {                                                                                    \
+        if (!(condition)) {                                                                 \
+            VkTests::Log::Error("{}:{}: check failed: {}", __FILE__, __LINE__, #condition); \
+            return false;                                                                   \
+        }                                                                                   \
+    } while (false)
+
+namespace {
+    using namespace VkTests;
+
+    std::string_view ToString(const std::vector<UInt8>& data) {
+        return {reinterpret_cast<const char*>(data.data()), data.size()};
+    }
+
+    bool TestFiles() {
+        Filesystem::MemoryFilesystem filesystem;
+
+        filesystem.WriteFile("/Shaders/Lighting/Common.glsl", std::string{"const float Pi = 3.14159;"});
+
+        VK_TESTS_CHECK(filesystem.IsFile("/Shaders/Lighting/Common.glsl"));
+        VK_TESTS_CHECK(filesystem.IsDirectory("/Shaders/Lighting"));
+        VK_TESTS_CHECK(filesystem.IsDirectory("/Shaders"));
+        VK_TESTS_CHECK(filesystem.ReadFileString("/Shaders/./Lighting/Common.glsl") == "const float Pi = 3.14159;");
+        VK_TESTS_CHECK(ToString(filesystem.ReadChunk("/Shaders/Lighting/Common.glsl", 6, 5)) == "float");
+        VK_TESTS_CHECK(filesystem.ReadChunk("/Shaders/Lighting/Common.glsl", 20, 10).empty());
+
+        // Directories are only removed once empty
+        filesystem.Remove("/Shaders/Lighting");
+        VK_TESTS_CHECK(filesystem.IsDirectory("/Shaders/Lighting"));
+
+        filesystem.Remove("/Shaders/Lighting/Common.glsl");
+        filesystem.Remove("/Shaders/Lighting");
+        VK_TESTS_CHECK(!filesystem.Exists("/Shaders/Lighting/Common.glsl"));
+        VK_TESTS_CHECK(!filesystem.Exists("/Shaders/Lighting"));
+        VK_TESTS_CHECK(filesystem.IsDirectory("/Shaders"));
+
+        VK_TESTS_CHECK(filesystem.CreateDirectory("/Output/Logs"));
+        VK_TESTS_CHECK(filesystem.IsDirectory("/Output"));
+
+        return true;
+    }
+
+    bool TestMappings() {
+        Filesystem::MemoryFilesystem filesystem;
+
+        filesystem.WriteFile("/a.bin", std::string(1000, 'a'));
+        filesystem.WriteFile("/b.bin", std::string(10, 'b'));
+        VK_TESTS_CHECK(filesystem.GetStorageSize() == 1010);
+
+        // A mapping keeps the contents it was made from, whatever happens to the file afterwards
+        const auto mapping = filesystem.MapFile("/a.bin");
+        filesystem.WriteFile("/a.bin", std::string(100, 'c'));
+
+        VK_TESTS_CHECK(mapping.GetString() == std::string(1000, 'a'));
+        VK_TESTS_CHECK(filesystem.ReadFileString("/a.bin") == std::string(100, 'c'));
+        VK_TESTS_CHECK(filesystem.GetStorageSize() == 110);
+
+        filesystem.Remove("/a.bin");
+        VK_TESTS_CHECK(mapping.GetString() == std::string(1000, 'a'));
+        VK_TESTS_CHECK(filesystem.GetStorageSize() == 10);
+
+        // Overwriting a file over and over doesn't accumulate its previous contents
+        for (USize i = 0; i < 1000; ++i) {
+            filesystem.WriteFile("/b.bin", std::string(i % 64, 'b'));
+        }
+        VK_TESTS_CHECK(filesystem.GetStorageSize() == 999 % 64);
+
+        filesystem.Clear();
+        VK_TESTS_CHECK(filesystem.GetFileCount() == 0);
+        VK_TESTS_CHECK(filesystem.GetStorageSize() == 0);
+        VK_TESTS_CHECK(mapping.GetString() == std::string(1000, 'a'));
+
+        return true;
+    }
+
+    bool TestTempMount() {
+        const auto assets = std::make_shared<Filesystem::MemoryFilesystem>();
+        const auto temp = std::make_shared<Filesystem::MemoryFilesystem>();
+
+        assets->WriteFile("/Assets/Scene.json", std::string{"{}"});
+
+        Filesystem::VirtualFilesystem filesystem{"/", "/tmp"};
+        filesystem.Mount("/", assets, 0, true);
+        filesystem.Mount("/tmp", temp);
+
+        filesystem.WriteFile("/tmp/Bake/Scene.bin", std::string{"baked"});
+
+        VK_TESTS_CHECK(filesystem.ReadFileString("/Assets/Scene.json") == "{}");
+        VK_TESTS_CHECK(filesystem.ReadFileString("/tmp/Bake/Scene.bin") == "baked");
+        VK_TESTS_CHECK(temp->IsFile("/tmp/Bake/Scene.bin"));
+        VK_TESTS_CHECK(!assets->Exists("/tmp/Bake/Scene.bin"));
+
+        // The assets are mounted read-only, the write is refused
+        filesystem.WriteFile("/Assets/Scene.json", std::string{"[]"});
+        VK_TESTS_CHECK(assets->ReadFileString("/Assets/Scene.json") == "{}");
+
+        return true;
+    }
+
+    bool TestShaderPipeline() {
+        const auto filesystem = std::make_shared<Filesystem::MemoryFilesystem>();
+        Filesystem::Set(filesystem);
+
+        filesystem->WriteFile("/Shaders/Common.glsl", std::string{
+            "#pragma once\n"
+            "const float Intensity = 0.5;\n"
+        });
+        filesystem->WriteFile("/Shaders/Test.frag", std::string{
+            "#version 450\n"
+            "#include \"Common.glsl\"\n"
+            "#include \"Common.glsl\"\n"
+            "layout(location = 0) out vec4 outColor;\n"
+            "void main() {\n"
+            "    outColor = vec4(Intensity);\n"
+            "}\n"
+        });
+
+        const ShaderSource source{"Test.frag"};
+        VK_TESTS_CHECK(!source.GetSource().empty());
+
+        ExpandedShaderSource expanded;
+        std::string infoLog;
+        VK_TESTS_CHECK(ShaderIncludeResolver::Get().Expand(source, expanded, infoLog));
+
+        // #pragma once expands the include a single time
+        const USize first = expanded.Buffer.find("const float Intensity");
+        VK_TESTS_CHECK(first != std::string::npos);
+        VK_TESTS_CHECK(expanded.Buffer.find("const float Intensity", first + 1) == std::string::npos);
+        VK_TESTS_CHECK(ShaderIncludeResolver::Get().GetDependencies("Test.frag") ==
+                       std::vector<std::string>{"Common.glsl"});
+
+        // The cache would write its entries to the filesystem, the module must come from glslang
+        ShaderCache::SetEnabled(false);
+
+        const auto session = GlslangSession::Acquire();
+        const auto result = ShaderModule::Compile(VK_SHADER_STAGE_FRAGMENT_BIT, source, "main", {});
+
+        if (!result.Success) {
+            Log::Error("Failed to compile shader \"Test.frag\":\n{}", result.InfoLog);
+            return false;
+        }
+
+        VK_TESTS_CHECK(!result.Spirv.empty());
+        VK_TESTS_CHECK(std::ranges::any_of(result.Resources, [](const ShaderResource& resource) {
+            return resource.Type == ShaderResourceType::Output && resource.Name == "outColor";
+        }));
+
+        return true;
+    }
+}
+
+CUSTOM_MAIN(context) {
+    static_cast<void>(context);
+
+    constexpr std::array<std::pair<std::string_view, bool (*)()>, 4> tests = {{
+        {"files", TestFiles},
+        {"mappings", TestMappings},
+        {"temp mount", TestTempMount},
+        {"shader pipeline", TestShaderPipeline}
+    }};
+
+    USize failureCount = 0;
+
+    for (const auto& [name, test] : tests) {
+        if (test()) {
+            Log::Info("{}: passed.", name);
+        } else {
+            Log::Error("{}: failed.", name);
+            ++failureCount;
+        }
+    }
+
+    if (failureCount > 0) {
+        Log::Error("{} of {} tests failed.", failureCount, tests.size());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,123 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+// Packs every file of the Assets directory into a single archive, served at runtime by PackFilesystem.
+//
+// Usage: AssetPacker [--input <directory>] [--output <archive>] [--compress] [--alignment <bytes>]
+//
+// Files are stored with their path relative to the input directory, so an archive mounted on the assets directory
+// serves them in place of the loose files. With --compress, files are compressed with LZ4 when it makes them
+// smaller, which requires the lz4 option. Files are aligned to 16 bytes unless another power of two is given.
+
+#include <VulkanTests/Platform/EntryPoint.hpp>
+
+#include <VulkanTests/Filesystem/Assets.hpp>
+#include <VulkanTests/Filesystem/Filesystem.hpp>
+#include <VulkanTests/Filesystem/PackFilesystem.hpp>
+
+#include <charconv>
+
+namespace {
+    using namespace VkTests;
+
+    struct PackOptions {
+        std::string Input;
+        std::string Output;
+        Filesystem::PackCompression Compression = Filesystem::PackCompression::None;
+        USize Alignment = Filesystem::PackFilesystem::DefaultAlignment;
+    };
+
+    bool ParseArguments(const std::vector<std::string>& arguments, PackOptions& options) {
+        options.Input = Filesystem::Paths::Get(Filesystem::Paths::Type::Assets);
+        options.Output = Filesystem::Paths::Get(Filesystem::Paths::Type::Storage) + "Assets.vpak";
+
+        for (USize i = 0; i < arguments.size(); ++i) {
+            const auto& argument = arguments[i];
+            const bool hasValue = i + 1 < arguments.size();
+
+            if (argument == "--input" && hasValue) {
+                options.Input = arguments[++i];
+            } else if (argument == "--output" && hasValue) {
+                options.Output = arguments[++i];
+            } else if (argument == "--compress") {
+                options.Compression = Filesystem::PackCompression::LZ4;
+            } else if (argument == "--alignment" && hasValue) {
+                const auto& value = arguments[++i];
+                const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), options.Alignment);
+
+                if (ec != std::errc{} || end != value.data() + value.size() || options.Alignment == 0 ||
+                    (options.Alignment & (options.Alignment - 1)) != 0) {
+                    Log::Error("The alignment must be a power of two, got \"{}\".", value);
+                    return false;
+                }
+            } else {
+                Log::Error("Unknown argument \"{}\".", argument);
+                return false;
+            }
+        }
+
+        if (!Filesystem::PackFilesystem::IsCompressionSupported(options.Compression)) {
+            Log::Error("This build can't compress archives, enable the lz4 option.");
+            return false;
+        }
+
+        return true;
+    }
+}
+
+CUSTOM_MAIN(context) {
+    Filesystem::InitializeWithContext(context);
+
+    PackOptions options{};
+    if (!ParseArguments(context.Arguments(), options)) {
+        return 1;
+    }
+
+    const std::filesystem::path root = options.Input;
+    if (!std::filesystem::is_directory(root)) {
+        Log::Error("Input directory \"{}\" doesn't exist.", options.Input);
+        return 1;
+    }
+
+    // Directory iteration order is unspecified, sorting keeps the archives reproducible
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+        if (entry.is_regular_file()) {
+            files.push_back(entry.path());
+        }
+    }
+
+    std::ranges::sort(files);
+
+    const auto fs = Filesystem::Get();
+    const auto output = std::filesystem::absolute(options.Output).lexically_normal();
+
+    Filesystem::PackWriter writer;
+    writer.SetAlignment(options.Alignment);
+
+    USize totalSize = 0;
+
+    for (const auto& file : files) {
+        // A previous archive written in the input directory isn't packed into the new one
+        if (std::filesystem::absolute(file).lexically_normal() == output) {
+            continue;
+        }
+
+        auto data = fs->ReadFileBinary(file);
+        totalSize += data.size();
+
+        writer.Add(std::filesystem::relative(file, root).generic_string(), std::move(data), options.Compression);
+    }
+
+    // Filesystem::WriteFile doesn't create missing parent directories on its own
+    std::error_code ec;
+    std::filesystem::create_directories(output.parent_path(), ec);
+
+    writer.Write(output);
+
+    Log::Info("Packed {} files ({} bytes) into \"{}\" ({} bytes).", writer.GetEntryCount(), totalSize,
+              output.string(), fs->StatFile(output).Size);
+
+    return 0;
+}
@@ -0,0 +1,231 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+// Compiles every shader of the Shaders directory into a single ShaderArchive.
+//
+// Usage: ShaderBaker [--manifest <file>] [--output <archive>] [--optimize <size|performance>] [--strip-debug]
+//                    [--remap] [--layout-header <file>] [-D<NAME[=VALUE]>]...
+//
+// Without a manifest, every file with a shader stage extension is baked with its "main" entry point.
+// HLSL shaders carry their stage before the .hlsl extension, such as "blur.comp.hlsl".
+// A manifest declares one shader per line, as a filename relative to the Shaders directory followed
+// by an optional "entry=<name>" and the defines of its variant. Lines starting with '#' are comments.
+// The -D defines are added to every variant, and variants are looked up at runtime with the same defines.
+// With --layout-header, a C++ header declaring the uniform, storage and push constant blocks of every baked
+// shader with their exact memory layout is written too, see ShaderLayoutGenerator.
+
+#include <VulkanTests/Platform/EntryPoint.hpp>
+
+#include <VulkanTests/Core/ThreadPool.hpp>
+
+#include <VulkanTests/Filesystem/Assets.hpp>
+#include <VulkanTests/Filesystem/Filesystem.hpp>
+
+#include <VulkanTests/Renderer/ShaderArchive.hpp>
+#include <VulkanTests/Renderer/ShaderCompileBatch.hpp>
+#include <VulkanTests/Renderer/ShaderLayoutGenerator.hpp>
+#include <VulkanTests/Renderer/ShaderStats.hpp>
+#include <VulkanTests/Renderer/SpirvReflection.hpp>
+
+#include <sstream>
+
+namespace {
+    using namespace VkTests;
+
+    struct BakeOptions {
+        std::string Manifest;
+        std::string Output;
+        std::string LayoutHeader;
+        ShaderVariant BaseVariant;
+    };
+
+    struct BakedShader {
+        std::string Filename;
+        std::string EntryPoint;
+        ShaderVariant Variant;
+    };
+
+    bool ParseArguments(const std::vector<std::string>& arguments, BakeOptions& options) {
+        options.Output = Filesystem::Paths::Get(Filesystem::Paths::Type::Storage) + "Shaders.vsar";
+
+        for (USize i = 0; i < arguments.size(); ++i) {
+            const auto& argument = arguments[i];
+            const bool hasValue = i + 1 < arguments.size();
+
+            if (argument == "--manifest" && hasValue) {
+                options.Manifest = arguments[++i];
+            } else if (argument == "--output" && hasValue) {
+                options.Output = arguments[++i];
+            } else if (argument == "--layout-header" && hasValue) {
+                options.LayoutHeader = arguments[++i];
+            } else if (argument == "--optimize" && hasValue) {
+                const auto& level = arguments[++i];
+                if (level == "size") {
+                    options.BaseVariant.SetOptimizationLevel(ShaderOptimizationLevel::Size);
+                } else if (level == "performance") {
+                    options.BaseVariant.SetOptimizationLevel(ShaderOptimizationLevel::Performance);
+                } else {
+                    Log::Error("Unknown optimization level \"{}\".", level);
+                    return false;
+                }
+            } else if (argument == "--strip-debug") {
+                options.BaseVariant.SetStripDebugInfo(true);
+            } else if (argument == "--remap") {
+                options.BaseVariant.SetRemap(true);
+            } else if (argument.starts_with("-D") && argument.size() > 2) {
+                options.BaseVariant.AddDefine(argument.substr(2));
+            } else {
+                Log::Error("Unknown argument \"{}\".", argument);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::vector<BakedShader> ReadManifest(const std::string& path, const ShaderVariant& baseVariant) {
+        std::vector<BakedShader> shaders;
+
+        std::istringstream stream{Filesystem::Get()->ReadFileString(path)};
+        std::string line;
+
+        while (std::getline(stream, line)) {
+            std::istringstream lineStream{line};
+
+            BakedShader shader{};
+            if (!(lineStream >> shader.Filename) || shader.Filename.starts_with('#')) {
+                continue;
+            }
+
+            shader.EntryPoint = "main";
+            shader.Variant = baseVariant;
+
+            for (std::string token; lineStream >> token;) {
+                if (token.starts_with("entry=")) {
+                    shader.EntryPoint = token.substr(6);
+                } else {
+                    shader.Variant.AddDefine(token);
+                }
+            }
+
+            shaders.push_back(std::move(shader));
+        }
+
+        return shaders;
+    }
+
+    std::vector<BakedShader> FindShaders(const ShaderVariant& baseVariant) {
+        std::vector<BakedShader> shaders;
+
+        const std::filesystem::path root = Filesystem::Paths::Get(Filesystem::Paths::Type::Shaders);
+        if (!std::filesystem::is_directory(root)) {
+            Log::Error("Shaders directory \"{}\" doesn't exist.", root.string());
+            return shaders;
+        }
+
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+            if (entry.is_regular_file() && FindShaderStage(entry.path())) {
+                shaders.push_back({std::filesystem::relative(entry.path(), root).generic_string(), "main",
+                                   baseVariant});
+            }
+        }
+
+        // Directory iteration order is unspecified, sorting keeps the logs reproducible
+        std::ranges::sort(shaders, {}, &BakedShader::Filename);
+
+        return shaders;
+    }
+}
+
+CUSTOM_MAIN(context) {
+    Filesystem::InitializeWithContext(context);
+
+    BakeOptions options{};
+    if (!ParseArguments(context.Arguments(), options)) {
+        return 1;
+    }
+
+    const auto shaders = options.Manifest.empty()
+                             ? FindShaders(options.BaseVariant)
+                             : ReadManifest(options.Manifest, options.BaseVariant);
+
+    if (shaders.empty()) {
+        Log::Error("No shader to bake.");
+        return 1;
+    }
+
+    ShaderCompileBatch batch;
+    std::vector<VkShaderStageFlagBits> stages;
+    std::vector<ShadingLanguage> languages;
+
+    for (const auto& shader : shaders) {
+        const auto stage = FindShaderStage(shader.Filename);
+        if (!stage) {
+            Log::Error("Can't deduce the stage of shader \"{}\" from its extension.", shader.Filename);
+            return 1;
+        }
+
+        const ShaderSource source{shader.Filename};
+
+        batch.Add(*stage, source, shader.EntryPoint, shader.Variant);
+        stages.push_back(*stage);
+        languages.push_back(source.GetLanguage());
+    }
+
+    Log::Info("Baking {} shaders.", batch.GetSize());
+
+    // The slowest shaders are the ones worth splitting or caching better
+    ShaderStats::SetEnabled(true);
+
+    ThreadPool threadPool;
+    const auto results = batch.Compile(threadPool);
+
+    ShaderStats::LogSummary();
+
+    ShaderArchiveWriter writer;
+    std::vector<ShaderBlockLayout> layouts;
+    USize failureCount = 0;
+
+    for (USize i = 0; i < results.size(); ++i) {
+        const auto& shader = shaders[i];
+
+        if (!results[i].Success) {
+            Log::Error("Failed to compile shader \"{}\":\n{}", shader.Filename, results[i].InfoLog);
+            ++failureCount;
+            continue;
+        }
+
+        const auto key = ShaderArchive::ComputeKey(stages[i], shader.Filename, languages[i], shader.EntryPoint,
+                                                   shader.Variant);
+        writer.Add(key, stages[i], results[i]);
+
+        if (!options.LayoutHeader.empty() && !SpirvReflection::ReflectBlockLayouts(results[i].Spirv, layouts)) {
+            Log::Error("Failed to reflect the block layouts of shader \"{}\".", shader.Filename);
+            ++failureCount;
+        }
+    }
+
+    if (failureCount > 0) {
+        Log::Error("{} shaders failed to bake, no archive written.", failureCount);
+        return 1;
+    }
+
+    // Filesystem::WriteFile doesn't create missing parent directories on its own
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path{options.Output}.parent_path(), ec);
+
+    writer.Write(options.Output);
+
+    Log::Info("Wrote {} shaders to \"{}\".", writer.GetEntryCount(), options.Output);
+
+    if (!options.LayoutHeader.empty()) {
+        std::filesystem::create_directories(std::filesystem::path{options.LayoutHeader}.parent_path(), ec);
+
+        Filesystem::Get()->WriteFile(options.LayoutHeader, ShaderLayoutGenerator::GenerateHeader(layouts, "Shaders"));
+
+        Log::Info("Wrote the layouts of {} blocks to \"{}\".", layouts.size(), options.LayoutHeader);
+    }
+
+    return 0;
+}
@@ -0,0 +1,501 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of Vulkan Tests.
+// For conditions of distribution and use, see copyright notice in Export.hpp
+
+// Measures the shader pipeline over every shader of the Shaders directory.
+//
+// Usage: ShaderBench [--iterations <count>] [benchmark]...
+//
+// Benchmarks:
+//   compile      Compile throughput, with glslang initialized for each shader, then once for the whole run, then
+//                on a thread pool.
+//   allocations  Heap allocations and allocated bytes per include expansion and per compilation, counted by the
+//                global operator new of this tool.
+//   reflection   Reflection time and peak heap usage per module, with the SPIRV-Cross backend and with the
+//                decoration scanner.
+//   enumeration  Time of the SPIRV-Cross resource enumeration per module, done once as the reflection does now,
+//                then once per resource type and once for the push constants as it used to.
+//
+// Without a benchmark name, every benchmark is run. The shader cache is disabled, so every compilation runs glslang.
+
+#include <VulkanTests/Platform/EntryPoint.hpp>
+
+#include <VulkanTests/Core/ThreadPool.hpp>
+
+#include <VulkanTests/Filesystem/Assets.hpp>
+#include <VulkanTests/Filesystem/Filesystem.hpp>
+
+#include <VulkanTests/Renderer/GlslangSession.hpp>
+#include <VulkanTests/Renderer/ShaderCache.hpp>
+#include <VulkanTests/Renderer/ShaderCompileBatch.hpp>
+#include <VulkanTests/Renderer/ShaderStats.hpp>
+#include <VulkanTests/Renderer/SpirvReflection.hpp>
+
+#include <VulkanTests/Renderer/ShaderIncludeResolver.hpp>
+
+#include <spirv_cross/spirv_cross.hpp>
+
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace {
+    // Every allocation of the process goes through the replaced operator new below
+    std::atomic<VkTests::USize> g_AllocationCount{0};
+    std::atomic<VkTests::USize> g_AllocatedBytes{0};
+    std::atomic<VkTests::USize> g_LiveBytes{0};
+    std::atomic<VkTests::USize> g_PeakBytes{0};
+
+    // Each allocation is prefixed with its size, for the deallocation to keep the live bytes up to date
+    constexpr std::size_t AllocationHeaderSize = alignof(std::max_align_t);
+}
+
+void* operator new(const std::size_t size) {
+    auto* block = static_cast<unsigned char*>(std::malloc(AllocationHeaderSize + size));
+    if (!block) {
+        throw std::bad_alloc{};
+    }
+
+    std::memcpy(block, &size, sizeof(size));
+
+    g_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    g_AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+    const VkTests::USize liveBytes = g_LiveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    VkTests::USize peakBytes = g_PeakBytes.load(std::memory_order_relaxed);
+    while (liveBytes > peakBytes &&
+           !g_PeakBytes.compare_exchange_weak(peakBytes, liveBytes, std::memory_order_relaxed)) {
+    }
+
+    return block + AllocationHeaderSize;
+}
+
+void operator delete(void* pointer) noexcept {
+    if (!pointer) {
+        return;
+    }
+
+    auto* block = static_cast<unsigned char*>(pointer) - AllocationHeaderSize;
+
+    std::size_t size;
+    std::memcpy(&size, block, sizeof(size));
+    g_LiveBytes.fetch_sub(size, std::memory_order_relaxed);
+
+    std::free(block);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    operator delete(pointer);
+}
+
+namespace {
+    using namespace VkTests;
+
+    using Clock = std::chrono::steady_clock;
+
+    struct BenchOptions {
+        std::vector<std::string> Benchmarks;
+        USize Iterations = 1;
+    };
+
+    struct BenchShader {
+        VkShaderStageFlagBits Stage;
+        ShaderSource Source;
+    };
+
+    bool ParseArguments(const std::vector<std::string>& arguments, BenchOptions& options) {
+        for (USize i = 0; i < arguments.size(); ++i) {
+            const auto& argument = arguments[i];
+            const bool hasValue = i + 1 < arguments.size();
+
+            if (argument == "--iterations" && hasValue) {
+                const auto& value = arguments[++i];
+                const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), options.Iterations);
+
+                if (ec != std::errc{} || end != value.data() + value.size() || options.Iterations == 0) {
+                    Log::Error("The iteration count must be a positive integer, got \"{}\".", value);
+                    return false;
+                }
+            } else if (argument == "compile" || argument == "allocations" || argument == "reflection" ||
+                       argument == "enumeration") {
+                options.Benchmarks.push_back(argument);
+            } else {
+                Log::Error("Unknown argument \"{}\".", argument);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::vector<BenchShader> FindShaders() {
+        std::vector<BenchShader> shaders;
+
+        const std::filesystem::path root = Filesystem::Paths::Get(Filesystem::Paths::Type::Shaders);
+        if (!std::filesystem::is_directory(root)) {
+            Log::Error("Shaders directory \"{}\" doesn't exist.", root.string());
+            return shaders;
+        }
+
+        std::vector<std::string> filenames;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+            if (entry.is_regular_file() && FindShaderStage(entry.path())) {
+                filenames.push_back(std::filesystem::relative(entry.path(), root).generic_string());
+            }
+        }
+
+        // Directory iteration order is unspecified, sorting keeps the runs comparable
+        std::ranges::sort(filenames);
+
+        for (const auto& filename : filenames) {
+            shaders.push_back({*FindShaderStage(filename), ShaderSource{filename}});
+        }
+
+        return shaders;
+    }
+
+    double ToMilliseconds(const Clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    void LogThroughput(const std::string_view name, const USize compileCount, const Clock::duration duration) {
+        const double milliseconds = ToMilliseconds(duration);
+
+        Log::Info("  {:<24} {:>10.2f} ms {:>10.1f} shaders/s", name, milliseconds,
+                  milliseconds > 0.0 ? static_cast<double>(compileCount) * 1000.0 / milliseconds : 0.0);
+    }
+
+    // Returns false if any shader failed to compile, the timings are then meaningless
+    bool CompileSerially(const std::vector<BenchShader>& shaders, const USize iterations) {
+        for (USize iteration = 0; iteration < iterations; ++iteration) {
+            for (const auto& shader : shaders) {
+                if (const auto result = ShaderModule::Compile(shader.Stage, shader.Source, "main", {});
+                    !result.Success) {
+                    Log::Error("Failed to compile shader \"{}\":\n{}", shader.Source.GetFilename(), result.InfoLog);
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool BenchCompile(const std::vector<BenchShader>& shaders, const USize iterations) {
+        const USize compileCount = shaders.size() * iterations;
+
+        Log::Info("compile: {} shaders, {} iterations.", shaders.size(), iterations);
+
+        // Without a session held, each compilation initializes and finalizes glslang on its own
+        auto start = Clock::now();
+        if (!CompileSerially(shaders, iterations)) {
+            return false;
+        }
+        LogThroughput("session per shader", compileCount, Clock::now() - start);
+
+        {
+            const auto session = GlslangSession::Acquire();
+
+            start = Clock::now();
+            if (!CompileSerially(shaders, iterations)) {
+                return false;
+            }
+            LogThroughput("shared session", compileCount, Clock::now() - start);
+        }
+
+        ShaderCompileBatch batch;
+        for (USize iteration = 0; iteration < iterations; ++iteration) {
+            for (const auto& shader : shaders) {
+                batch.Add(shader.Stage, shader.Source, "main", {});
+            }
+        }
+
+        ThreadPool threadPool;
+
+        start = Clock::now();
+        const auto results = batch.Compile(threadPool);
+        const auto duration = Clock::now() - start;
+
+        if (std::ranges::any_of(results, [](const ShaderCompileResult& result) { return !result.Success; })) {
+            Log::Error("Some shaders failed to compile on the thread pool.");
+            return false;
+        }
+
+        LogThroughput(fmt::format("batch, {} workers", threadPool.GetThreadCount()), compileCount, duration);
+
+        return true;
+    }
+
+    struct AllocationCounts {
+        USize Count = 0;
+        USize Bytes = 0;
+
+        [[nodiscard]] static AllocationCounts Now() {
+            return {
+                g_AllocationCount.load(std::memory_order_relaxed), g_AllocatedBytes.load(std::memory_order_relaxed)
+            };
+        }
+
+        [[nodiscard]] AllocationCounts operator-(const AllocationCounts& other) const {
+            return {Count - other.Count, Bytes - other.Bytes};
+        }
+
+        AllocationCounts& operator+=(const AllocationCounts& other) {
+            Count += other.Count;
+            Bytes += other.Bytes;
+            return *this;
+        }
+    };
+
+    void LogAllocations(const std::string_view name, const AllocationCounts& counts, const USize shaderCount) {
+        const auto divisor = static_cast<double>(shaderCount);
+
+        Log::Info("  {:<24} {:>10.1f} allocations {:>12.1f} bytes per shader", name,
+                  static_cast<double>(counts.Count) / divisor, static_cast<double>(counts.Bytes) / divisor);
+    }
+
+    // The counters are process-wide, shaders are measured one at a time with no other thread at work
+    bool BenchAllocations(const std::vector<BenchShader>& shaders, const USize iterations) {
+        Log::Info("allocations: {} shaders, {} iterations.", shaders.size(), iterations);
+
+        const auto session = GlslangSession::Acquire();
+        auto& resolver = ShaderIncludeResolver::Get();
+
+        USize sourceSize = 0;
+        AllocationCounts expansion{};
+        AllocationCounts compilation{};
+
+        for (const auto& shader : shaders) {
+            ExpandedShaderSource expanded;
+            std::string infoLog;
+
+            // The first expansion reads and parses the includes, which the following ones reuse
+            if (!resolver.Expand(shader.Source, expanded, infoLog)) {
+                Log::Error("Failed to expand shader \"{}\":\n{}", shader.Source.GetFilename(), infoLog);
+                return false;
+            }
+
+            sourceSize += expanded.Buffer.size() * iterations;
+
+            for (USize iteration = 0; iteration < iterations; ++iteration) {
+                ExpandedShaderSource output;
+
+                const auto start = AllocationCounts::Now();
+                const bool success = resolver.Expand(shader.Source, output, infoLog);
+                expansion += AllocationCounts::Now() - start;
+
+                if (!success) {
+                    return false;
+                }
+            }
+
+            for (USize iteration = 0; iteration < iterations; ++iteration) {
+                const auto start = AllocationCounts::Now();
+                const auto result = ShaderModule::Compile(shader.Stage, shader.Source, "main", {});
+                compilation += AllocationCounts::Now() - start;
+
+                if (!result.Success) {
+                    Log::Error("Failed to compile shader \"{}\":\n{}", shader.Source.GetFilename(), result.InfoLog);
+                    return false;
+                }
+            }
+        }
+
+        const USize runCount = shaders.size() * iterations;
+
+        Log::Info("  {:<24} {:>10.1f} bytes per shader", "expanded source",
+                  static_cast<double>(sourceSize) / static_cast<double>(runCount));
+        LogAllocations("include expansion", expansion, runCount);
+        LogAllocations("whole compilation", compilation, runCount);
+
+        return true;
+    }
+
+    struct ReflectionMeasure {
+        Clock::duration Duration{};
+        USize PeakBytes = 0;
+        USize MaxPeakBytes = 0;
+    };
+
+    // Returns false if the backend failed to reflect a module
+    bool MeasureReflection(const std::vector<BenchShader>& shaders, const std::vector<std::vector<UInt32>>& modules,
+                           const USize iterations, ReflectionMeasure& measure) {
+        SpirvReflection reflection;
+        std::vector<ShaderResource> resources;
+
+        for (USize i = 0; i < modules.size(); ++i) {
+            // The peak is measured over the first reflection, the following ones only add to the time
+            const USize baseline = g_LiveBytes.load(std::memory_order_relaxed);
+            g_PeakBytes.store(baseline, std::memory_order_relaxed);
+
+            const auto start = Clock::now();
+            for (USize iteration = 0; iteration < iterations; ++iteration) {
+                resources.clear();
+
+                if (!reflection.ReflectShaderResources(shaders[i].Stage, modules[i], resources, {})) {
+                    Log::Error("Failed to reflect shader \"{}\".", shaders[i].Source.GetFilename());
+                    return false;
+                }
+
+                if (iteration == 0) {
+                    const USize peakBytes = g_PeakBytes.load(std::memory_order_relaxed) - baseline;
+                    measure.PeakBytes += peakBytes;
+                    measure.MaxPeakBytes = std::max(measure.MaxPeakBytes, peakBytes);
+                }
+            }
+            measure.Duration += Clock::now() - start;
+        }
+
+        return true;
+    }
+
+    // Returns false if any shader failed to compile
+    bool CompileModules(const std::vector<BenchShader>& shaders, std::vector<std::vector<UInt32>>& modules) {
+        const auto session = GlslangSession::Acquire();
+
+        modules.reserve(shaders.size());
+
+        for (const auto& shader : shaders) {
+            auto result = ShaderModule::Compile(shader.Stage, shader.Source, "main", {});
+            if (!result.Success) {
+                Log::Error("Failed to compile shader \"{}\":\n{}", shader.Source.GetFilename(), result.InfoLog);
+                return false;
+            }
+
+            modules.push_back(std::move(result.Spirv));
+        }
+
+        return true;
+    }
+
+    bool BenchReflection(const std::vector<BenchShader>& shaders, const USize iterations) {
+        Log::Info("reflection: {} shaders, {} iterations.", shaders.size(), iterations);
+
+        std::vector<std::vector<UInt32>> modules;
+        if (!CompileModules(shaders, modules)) {
+            return false;
+        }
+
+        const auto previousBackend = SpirvReflection::GetBackend();
+
+        constexpr std::array<std::pair<std::string_view, SpirvReflectionBackend>, 2> backends = {{
+            {"SPIRV-Cross", SpirvReflectionBackend::SpirvCross},
+            {"decoration scanner", SpirvReflectionBackend::DecorationScanner}
+        }};
+
+        for (const auto& [name, backend] : backends) {
+            SpirvReflection::SetBackend(backend);
+
+            ReflectionMeasure measure{};
+            if (!MeasureReflection(shaders, modules, iterations, measure)) {
+                SpirvReflection::SetBackend(previousBackend);
+                return false;
+            }
+
+            const auto moduleCount = static_cast<double>(modules.size());
+
+            Log::Info("  {:<24} {:>10.1f} us per module {:>12.1f} peak bytes per module {:>12} at most", name,
+                      ToMilliseconds(measure.Duration) * 1000.0 / (moduleCount * static_cast<double>(iterations)),
+                      static_cast<double>(measure.PeakBytes) / moduleCount, measure.MaxPeakBytes);
+        }
+
+        SpirvReflection::SetBackend(previousBackend);
+
+        return true;
+    }
+
+    bool BenchEnumeration(const std::vector<BenchShader>& shaders, const USize iterations) {
+        // The nine resource types read by ParseShaderResources() and the push constants
+        constexpr USize PerTypeEnumerationCount = 10;
+
+        Log::Info("enumeration: {} shaders, {} iterations.", shaders.size(), iterations);
+
+        std::vector<std::vector<UInt32>> modules;
+        if (!CompileModules(shaders, modules)) {
+            return false;
+        }
+
+        Clock::duration parsing{};
+        Clock::duration single{};
+        Clock::duration perType{};
+        USize resourceCount = 0;
+
+        for (const auto& module : modules) {
+            auto start = Clock::now();
+            const spirv_cross::Compiler compiler{module};
+            parsing += Clock::now() - start;
+
+            start = Clock::now();
+            for (USize iteration = 0; iteration < iterations; ++iteration) {
+                resourceCount += compiler.get_shader_resources().stage_inputs.size();
+            }
+            single += Clock::now() - start;
+
+            start = Clock::now();
+            for (USize iteration = 0; iteration < iterations * PerTypeEnumerationCount; ++iteration) {
+                resourceCount += compiler.get_shader_resources().stage_inputs.size();
+            }
+            perType += Clock::now() - start;
+        }
+
+        const auto logTime = [](const std::string_view name, const Clock::duration duration, const USize runCount) {
+            Log::Info("  {:<24} {:>10.1f} us per module", name,
+                      ToMilliseconds(duration) * 1000.0 / static_cast<double>(runCount));
+        };
+
+        logTime("module parsing", parsing, modules.size());
+        logTime("single enumeration", single, modules.size() * iterations);
+        logTime("enumeration per type", perType, modules.size() * iterations);
+
+        // The resource count keeps the enumerations from being optimized away
+        Log::Debug("  {} stage inputs enumerated.", resourceCount);
+
+        return true;
+    }
+}
+
+CUSTOM_MAIN(context) {
+    Filesystem::InitializeWithContext(context);
+
+    BenchOptions options{};
+    if (!ParseArguments(context.Arguments(), options)) {
+        return 1;
+    }
+
+    if (options.Benchmarks.empty()) {
+        options.Benchmarks = {"compile", "allocations", "reflection", "enumeration"};
+    }
+
+    const auto shaders = FindShaders();
+    if (shaders.empty()) {
+        Log::Error("No shader to benchmark.");
+        return 1;
+    }
+
+    // Every iteration must run the whole pipeline, and the statistics would grow with each compilation
+    ShaderCache::SetEnabled(false);
+    ShaderStats::SetEnabled(false);
+
+    for (const auto& benchmark : options.Benchmarks) {
+        if (benchmark == "compile" && !BenchCompile(shaders, options.Iterations)) {
+            return 1;
+        }
+
+        if (benchmark == "allocations" && !BenchAllocations(shaders, options.Iterations)) {
+            return 1;
+        }
+
+        if (benchmark == "reflection" && !BenchReflection(shaders, options.Iterations)) {
+            return 1;
+        }
+
+        if (benchmark == "enumeration" && !BenchEnumeration(shaders, options.Iterations)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
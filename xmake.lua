@@ -10,7 +10,7 @@ set_languages("cxx20")
 add_repositories("pixfri https://github.com/Pixfri/xmake-repo")
 
 add_requires("glfw", "glm", "spdlog v1.9.0", "volk", "vulkan-memory-allocator", "stb", "glslang", 
-             "spirv-cross", "spirv-reflect", "spirv-tools")
+             "spirv-cross", "spirv-reflect", "spirv-tools", "xxhash")
 add_requires("ktx")
 
 local outputdir = "$(mode)-$(os)-$(arch)"
@@ -34,11 +34,24 @@ if has_config("tracy") then
     add_requires("tracy")
 end
 
+option("io-uring", {description = "Use io_uring for asynchronous file I/O (Linux only, requires liburing)", default = false, type = "boolean"})
+
+if has_config("io-uring") and is_plat("linux") then
+    add_requires("liburing")
+end
+
+option("lz4", {description = "Enable LZ4 compression of packed asset archives", default = false, type = "boolean"})
+
+if has_config("lz4") then
+    add_requires("lz4")
+end
+
 option("vk-validation-layers", {description = "Enable Vulkan validation layers (requires the Vulkan SDK to be installed on your machine)", default = is_mode("debug"), type = "boolean"})
 option("vk-validation-layers-gpu-assisted", {description = "Enable GPU-assisted validation layers", default = false, type = "boolean"})
 option("vk-validation-layers-best-practices", {description = "Enable best practices validation layers", default = false, type = "boolean"})
 option("vk-validation-layers-synchronization", {description = "Enable synchronization validation layers", default = false, type = "boolean"})
 option("vk-portability", {description = "Enable Vulkan Portability Enumeration and Portability Subset extensions", default = false, type = "boolean"})
+option("shader-validation", {description = "Validate the generated SPIR-V with spirv-tools", default = is_mode("debug"), type = "boolean"})
 
 add_defines("VK_NO_PROTOTYPES")
 
@@ -87,16 +100,73 @@ target("VulkanTests")
     if has_config("vk-portability") then
         add_defines("VK_TESTS_PORTABILITY")
     end
+
+    if has_config("shader-validation") then
+        add_defines("VK_TESTS_SHADER_VALIDATION")
+    end
     
     if has_config("tracy") then
         add_defines("TRACY_ENABLE")
         add_packages("tracy")
     end
 
+    if has_config("io-uring") and is_plat("linux") then
+        add_defines("VK_TESTS_IO_URING")
+        add_packages("liburing")
+    end
+
+    if has_config("lz4") then
+        add_defines("VK_TESTS_LZ4")
+        add_packages("lz4")
+    end
+
     set_pcxxheader("Include/VulkanTests/pch.hpp")
 
     add_packages("glfw", "glm", "spdlog", "volk", "vulkan-memory-allocator", "glslang", "stb", "spirv-cross", 
-                 "spirv-reflect", "spirv-tools")
+                 "spirv-reflect", "spirv-tools", "xxhash")
     add_packages("ktx")
 
+-- A binary linked against the VulkanTests library, with the packages the library uses. The target stays open, so the
+-- calls following it add to the target.
+local function vulkantests_binary(name, files)
+    target(name)
+        set_kind("binary")
+        add_deps("VulkanTests")
+
+        set_targetdir("build/" .. outputdir .. "/" .. name .. "/bin")
+        set_objectdir("build/" .. outputdir .. "/" .. name .. "/obj")
+
+        add_files(files)
+        add_includedirs("Include", "ThirdParty")
+
+        add_packages("glfw", "glm", "spdlog", "volk", "vulkan-memory-allocator", "glslang", "stb", "spirv-cross", 
+                     "spirv-reflect", "spirv-tools", "xxhash")
+        add_packages("ktx")
+
+        if has_config("tracy") then
+            add_packages("tracy")
+        end
+
+        if has_config("io-uring") and is_plat("linux") then
+            add_packages("liburing")
+        end
+
+        if has_config("lz4") then
+            add_packages("lz4")
+        end
+end
+
+vulkantests_binary("ShaderBaker", "Tools/ShaderBaker/**.cpp")
+
+vulkantests_binary("AssetPacker", "Tools/AssetPacker/**.cpp")
+
+vulkantests_binary("ShaderBench", "Tools/ShaderBench/**.cpp")
+    set_default(false)
+
+vulkantests_binary("MemoryFilesystemTests", "Tests/MemoryFilesystemTests/**.cpp")
+    set_default(false)
+
+    -- Run with `xmake test`, the tests don't touch the disk
+    add_tests("default")
+
 includes("xmake/**.lua")
\ No newline at end of file